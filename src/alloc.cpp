@@ -1,78 +1,997 @@
 #include "alloc.hpp"
 #include "engine.hpp"
 #include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
 #include <cstdlib>
 #include <cstring>
-#include <malloc.h>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <new>
 
-namespace utils {
+#ifdef __linux__
+#include <execinfo.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
-static i32 alloc_counter = 0;
+namespace utils {
 
 constexpr usize alignment = 16;
 constexpr usize align_size(const usize size) { return ((size - 1) | (alignment - 1)) + 1; }
 
-void *aligned_alloc_16(usize size) {
+// system
+
+static void *system_alloc(const usize size) {
+#ifdef _WIN32
+  void *memory = _aligned_malloc(align_size(size), alignment);
+#else
+  void *memory = aligned_alloc(alignment, align_size(size));
+#endif
 
-  alloc_counter++;
+  LOG_ASSERT(memory != nullptr);
 
-  size = align_size(size);
+  return memory;
+}
 
+static void *system_realloc(void *memory, const usize size) {
 #ifdef _WIN32
-  void *ptr = _aligned_malloc(size, alignment);
+  void *resized = _aligned_realloc(memory, align_size(size), alignment);
 #else
-  void *ptr = aligned_alloc(alignment, size);
+  // malloc is aligned enough, so plain realloc can extend aligned_alloc blocks in place
+  static_assert(alignof(std::max_align_t) >= alignment);
+  void *resized = realloc(memory, align_size(size));
 #endif
 
-  // memset(ptr, 0, size);
+  LOG_ASSERT(resized != nullptr);
 
-  return ptr;
+  return resized;
 }
 
-void aligned_free_16(void *value) {
-  if (value == nullptr) {
+static void system_free(void *memory) {
+#ifdef _WIN32
+  _aligned_free(memory);
+#else
+  free(memory);
+#endif
+}
+
+// pool
+//
+// every block starts with a header, so frees know the size and owner without a lookup. small blocks are carved from
+// spans of one size class, large ones come straight from the system and huge ones are mapped, so growing them remaps
+// pages instead of copying. every thread allocates from its own heap without
+// locking, frees from other threads go onto the span's lock free list and are collected by the owner when it runs
+// out of slots
+
+struct Span;
+
+struct Header {
+  // the large_span of the owning heap for large blocks
+  Span *span;
+
+  // usable bytes after the header
+  u64 size : 56;
+
+  // MemoryTag of the current allocation, slots are reused across tags
+  u64 tag : 8;
+};
+
+static_assert(sizeof(Header) == alignment);
+
+struct FreeSlot {
+  FreeSlot *next;
+};
+
+// 16 byte steps up to 128, then four steps per power of two
+constexpr usize linear_class_count = 8;
+constexpr usize size_class_count = 40;
+
+constexpr usize get_slot_size(const usize size_class) {
+  if (size_class < linear_class_count) {
+    return (size_class + 1) * alignment;
+  }
+
+  const usize step = size_class - linear_class_count;
+  const usize exponent = 7 + step / 4;
+
+  return (usize(1) << exponent) + (step % 4 + 1) * (usize(1) << (exponent - 2));
+}
+
+// header included, anything bigger is a large block
+constexpr usize max_slot_size = get_slot_size(size_class_count - 1);
+
+static_assert(max_slot_size == 32 * 1024);
+
+// slot_size is a multiple of the alignment and at most max_slot_size
+static usize get_size_class(const usize slot_size) {
+  if (slot_size <= linear_class_count * alignment) {
+    return slot_size / alignment - 1;
+  }
+
+  const usize exponent = std::bit_width(slot_size - 1) - 1;
+
+  return linear_class_count + (exponent - 7) * 4 + ((slot_size - 1 - (usize(1) << exponent)) >> (exponent - 2));
+}
+
+// marks the stand-in span of large blocks
+constexpr u32 large_size_class = size_class_count;
+
+constexpr usize min_span_size = 64 * 1024;
+constexpr usize min_span_slots = 8;
+
+struct Heap;
+
+struct Span {
+  Heap *heap;
+
+  // in the available or full list of its size class
+  Span *previous;
+  Span *next;
+
+  // owner only
+  FreeSlot *free;
+  u8 *bump;
+  u8 *end;
+  u32 size_class;
+  u32 used;
+  bool full;
+
+  // pushed by other threads
+  std::atomic<FreeSlot *> remote_free;
+};
+
+constexpr usize span_header_size = align_size(sizeof(Span));
+
+struct SpanList {
+  Span *first;
+
+  void push(Span *span) {
+    span->previous = nullptr;
+    span->next = first;
+
+    if (first != nullptr) {
+      first->previous = span;
+    }
+
+    first = span;
+  }
+
+  void remove(Span *span) {
+    if (span->previous != nullptr) {
+      span->previous->next = span->next;
+    } else {
+      first = span->next;
+    }
+
+    if (span->next != nullptr) {
+      span->next->previous = span->previous;
+    }
+  }
+};
+
+constexpr usize tag_count = static_cast<usize>(MemoryTag::COUNT);
+
+struct TagCounters {
+  // allocated minus freed by the owning thread
+  std::atomic<i64> blocks;
+  std::atomic<i64> bytes;
+  std::atomic<u64> allocs;
+
+  // highest live bytes of the heap, remote changes included
+  std::atomic<i64> peak_bytes;
+
+  // frees and resizes of the heap's blocks by other threads, next to the rest since the owner reads them on every
+  // allocation
+  std::atomic<i64> remote_blocks;
+  std::atomic<i64> remote_bytes;
+};
+
+struct Heap {
+  // the first available span is the one allocated from, full ones are only revisited for remote frees
+  SpanList available[size_class_count];
+  SpanList full[size_class_count];
+
+  // never allocated from, large blocks point to it so frees find their heap
+  Span large_span;
+
+  // only written by the owning thread, except for the remote counters
+  TagCounters counters[tag_count];
+  u32 sample_counter;
+
+  Heap *next_heap;
+  Heap *next_orphan;
+};
+
+// heaps are never destroyed, the heap of an exited thread waits for the next new thread
+static std::mutex heaps_mutex;
+static Heap *all_heaps = nullptr;
+static Heap *orphan_heaps = nullptr;
+
+static thread_local Heap *thread_heap = nullptr;
+static thread_local bool thread_exited = false;
+static thread_local MemoryTag thread_tag = MemoryTag::GENERAL;
+
+struct HeapGuard {
+  ~HeapGuard() {
+    const std::lock_guard lock(heaps_mutex);
+
+    thread_heap->next_orphan = orphan_heaps;
+    orphan_heaps = thread_heap;
+
+    thread_heap = nullptr;
+    thread_exited = true;
+  }
+};
+
+static thread_local HeapGuard heap_guard;
+
+static Heap *acquire_heap() {
+  const std::lock_guard lock(heaps_mutex);
+
+  Heap *heap = orphan_heaps;
+
+  if (heap != nullptr) {
+    orphan_heaps = heap->next_orphan;
+  } else {
+    heap = new (system_alloc(sizeof(Heap))) Heap();
+    heap->large_span.heap = heap;
+    heap->large_span.size_class = large_size_class;
+    heap->next_heap = all_heaps;
+    all_heaps = heap;
+  }
+
+  // registers the destructor, a thread that is already exiting keeps the heap
+  if (!thread_exited) {
+    [[maybe_unused]] volatile HeapGuard *guard = &heap_guard;
+  }
+
+  return heap;
+}
+
+static Heap *get_heap() {
+  if (thread_heap == nullptr) [[unlikely]] {
+    thread_heap = acquire_heap();
+  }
+
+  return thread_heap;
+}
+
+static void add_relaxed(std::atomic<i64> &counter, const i64 delta) {
+  counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+// counted on the heap the block came from, so every heap's live bytes are its own. other threads, including ones
+// that have given up their heap, go through the remote counters
+static void count(Heap *owner, const usize tag, const i64 blocks, const i64 bytes) {
+  TagCounters &counters = owner->counters[tag];
+
+  if (owner != thread_heap) {
+    counters.remote_blocks.fetch_add(blocks, std::memory_order_relaxed);
+    counters.remote_bytes.fetch_add(bytes, std::memory_order_relaxed);
     return;
   }
 
-  alloc_counter--;
+  add_relaxed(counters.blocks, blocks);
+  add_relaxed(counters.bytes, bytes);
 
-#ifdef _WIN32
-  return _aligned_free(value);
+  if (blocks > 0) {
+    counters.allocs.store(counters.allocs.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  // other threads mostly free, so the high water mark only moves here
+  if (bytes > 0) {
+    const i64 live =
+        counters.bytes.load(std::memory_order_relaxed) + counters.remote_bytes.load(std::memory_order_relaxed);
+
+    if (live > counters.peak_bytes.load(std::memory_order_relaxed)) {
+      counters.peak_bytes.store(live, std::memory_order_relaxed);
+    }
+  }
+}
+
+static Header *get_header(void *memory) { return static_cast<Header *>(memory) - 1; }
+
+static bool is_large(const Header *header) { return header->span->size_class == large_size_class; }
+
+static usize get_span_size(const usize size_class) {
+  return std::max(min_span_size, span_header_size + get_slot_size(size_class) * min_span_slots);
+}
+
+static Span *make_span(Heap *heap, const usize size_class) {
+  const usize span_size = get_span_size(size_class);
+  const usize slot_size = get_slot_size(size_class);
+
+  u8 *memory = static_cast<u8 *>(system_alloc(span_size));
+  Span *span = new (memory) Span();
+
+  span->heap = heap;
+  span->bump = memory + span_header_size;
+  span->end = span->bump + (span_size - span_header_size) / slot_size * slot_size;
+  span->size_class = static_cast<u32>(size_class);
+
+  return span;
+}
+
+// moves the slots other threads freed to the local free list
+static bool collect_remote(Span *span) {
+  FreeSlot *slots = span->remote_free.exchange(nullptr, std::memory_order_acquire);
+
+  if (slots == nullptr) {
+    return false;
+  }
+
+  FreeSlot *last = slots;
+  u32 count = 1;
+
+  while (last->next != nullptr) {
+    last = last->next;
+    count++;
+  }
+
+  last->next = span->free;
+  span->free = slots;
+  span->used -= count;
+
+  return true;
+}
+
+static void *span_alloc(Span *span) {
+  if (span->free == nullptr && span->bump == span->end && !collect_remote(span)) {
+    return nullptr;
+  }
+
+  span->used++;
+
+  if (span->free != nullptr) {
+    FreeSlot *slot = span->free;
+    span->free = slot->next;
+
+    return slot;
+  }
+
+  const usize slot_size = get_slot_size(span->size_class);
+
+  Header *header = reinterpret_cast<Header *>(span->bump);
+  *header = {.span = span, .size = slot_size - sizeof(Header), .tag = 0};
+
+  span->bump += slot_size;
+
+  return header + 1;
+}
+
+static void *alloc_small(Heap *heap, const usize size_class) {
+  SpanList &available = heap->available[size_class];
+  SpanList &full = heap->full[size_class];
+
+  while (available.first != nullptr) {
+    Span *span = available.first;
+
+    if (void *memory = span_alloc(span)) {
+      return memory;
+    }
+
+    available.remove(span);
+    full.push(span);
+    span->full = true;
+  }
+
+  // before asking the system, full spans might have been freed into by other threads
+  for (Span *span = full.first; span != nullptr;) {
+    Span *next = span->next;
+
+    if (span->remote_free.load(std::memory_order_relaxed) != nullptr) {
+      full.remove(span);
+      available.push(span);
+      span->full = false;
+    }
+
+    span = next;
+  }
+
+  if (available.first == nullptr) {
+    available.push(make_span(heap, size_class));
+  }
+
+  return span_alloc(available.first);
+}
+
+static void free_small(Heap *heap, Span *span, FreeSlot *slot) {
+  if (span->heap != heap) {
+    FreeSlot *first = span->remote_free.load(std::memory_order_relaxed);
+
+    do {
+      slot->next = first;
+    } while (!span->remote_free.compare_exchange_weak(first, slot, std::memory_order_release,
+                                                      std::memory_order_relaxed));
+
+    return;
+  }
+
+  slot->next = span->free;
+  span->free = slot;
+  span->used--;
+
+  if (span->full) {
+    heap->full[span->size_class].remove(span);
+    heap->available[span->size_class].push(span);
+    span->full = false;
+  } else if (span->used == 0 && heap->available[span->size_class].first != span) {
+    // the first one stays to avoid thrashing on a single block
+    heap->available[span->size_class].remove(span);
+    span->~Span();
+    system_free(span);
+  }
+}
+
+// large and huge blocks
+
+#ifdef __linux__
+constexpr usize min_mapped_size = 4 * 1024 * 1024;
+
+static usize align_page(const usize size) {
+  static const usize page_size = static_cast<usize>(sysconf(_SC_PAGESIZE));
+
+  return (size + page_size - 1) / page_size * page_size;
+}
 #else
-  free(value);
+constexpr usize min_mapped_size = std::numeric_limits<usize>::max();
+#endif
+
+// mapped blocks are page rounded, so their size never drops below the threshold
+static bool is_mapped(const Header *header) { return header->size + sizeof(Header) >= min_mapped_size; }
+
+static Header *alloc_large(Heap *heap, const usize block_size, const usize tag) {
+  Header *header = nullptr;
+  usize size = block_size;
+
+#ifdef __linux__
+  if (block_size >= min_mapped_size) {
+    size = align_page(block_size);
+
+    void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    LOG_ASSERT(memory != MAP_FAILED);
+
+    header = static_cast<Header *>(memory);
+  }
+#endif
+
+  if (header == nullptr) {
+    header = static_cast<Header *>(system_alloc(block_size));
+  }
+
+  *header = {.span = &heap->large_span, .size = size - sizeof(Header), .tag = tag};
+
+  return header;
+}
+
+static void free_large(Header *header) {
+#ifdef __linux__
+  if (is_mapped(header)) {
+    munmap(header, header->size + sizeof(Header));
+    return;
+  }
 #endif
+
+  system_free(header);
 }
 
-void *aligned_realloc_16(void *old_memory, usize size) {
-  size = align_size(size);
+// null if the block has to move between the system and a mapping
+static Header *realloc_large(Header *header, const usize block_size) {
+  const bool mapped = is_mapped(header);
 
-#ifdef _WIN32
-  if (size != 0) {
-    alloc_counter++;
+#ifdef __linux__
+  if (mapped && block_size >= min_mapped_size) {
+    const usize size = align_page(block_size);
+
+    void *memory = mremap(header, header->size + sizeof(Header), size, MREMAP_MAYMOVE);
+    LOG_ASSERT(memory != MAP_FAILED);
+
+    Header *resized = static_cast<Header *>(memory);
+    resized->size = size - sizeof(Header);
+
+    return resized;
   }
-  if (old_memory) {
-    alloc_counter--;
+#endif
+
+  if (!mapped && block_size < min_mapped_size) {
+    Header *resized = static_cast<Header *>(system_realloc(header, block_size));
+    resized->size = block_size - sizeof(Header);
+
+    return resized;
   }
 
-  return _aligned_realloc(old_memory, size, alignment);
-#else
-  void *new_memory = nullptr;
+  return nullptr;
+}
+
+// sampling
+
+constexpr usize max_site_frames = 16;
+constexpr usize max_sites = 1024;
+
+struct Site {
+  u64 hash;
+  void *frames[max_site_frames];
+  u32 frame_count;
+  MemoryTag tag;
+  u64 samples;
+  u64 bytes;
+};
+
+static std::atomic<u32> sample_rate = 0;
+
+// open addressing by stack hash, samples of new stacks are dropped once it is full
+static std::mutex sites_mutex;
+static Site sites[max_sites];
+static usize site_count = 0;
+static u64 dropped_samples = 0;
+
+static void record_site([[maybe_unused]] const usize size, [[maybe_unused]] const usize tag) {
+#ifdef __linux__
+  // the allocator's own frames are skipped
+  constexpr i32 skipped_frames = 2;
+
+  void *frames[max_site_frames + skipped_frames];
+  const i32 frame_count = std::max(backtrace(frames, max_site_frames + skipped_frames) - skipped_frames, 0);
+
+  u64 hash = 14695981039346656037ull ^ tag;
+
+  for (i32 i_frame = 0; i_frame < frame_count; i_frame++) {
+    hash = (hash ^ reinterpret_cast<uintptr_t>(frames[i_frame + skipped_frames])) * 1099511628211ull;
+  }
+
+  const std::lock_guard lock(sites_mutex);
 
-  if (size != 0) {
-    new_memory = aligned_alloc_16(size);
+  for (usize i_probe = 0; i_probe < max_sites; i_probe++) {
+    Site &site = sites[(hash + i_probe) % max_sites];
 
-    if (old_memory) {
-      const usize copy_size = std::min(malloc_usable_size(old_memory), size);
+    if (site.samples == 0) {
+      if (site_count == max_sites / 2) {
+        break;
+      }
 
-      memcpy(new_memory, old_memory, copy_size);
+      site.hash = hash;
+      site.frame_count = static_cast<u32>(frame_count);
+      site.tag = static_cast<MemoryTag>(tag);
+      memcpy(site.frames, frames + skipped_frames, frame_count * sizeof(void *));
+      site_count++;
+    } else if (site.hash != hash) {
+      continue;
     }
+
+    site.samples++;
+    site.bytes += size;
+
+    return;
+  }
+
+  dropped_samples++;
+#endif
+}
+
+// allocator
+
+static void *alloc_tagged(const usize size, const usize tag) {
+  Heap *heap = get_heap();
+
+  const usize slot_size = align_size(std::max<usize>(size, 1)) + sizeof(Header);
+
+  Header *header;
+
+  if (slot_size <= max_slot_size) {
+    header = get_header(alloc_small(heap, get_size_class(slot_size)));
+    header->tag = tag;
+  } else {
+    header = alloc_large(heap, slot_size, tag);
   }
+
+  count(heap, tag, 1, static_cast<i64>(header->size));
+
+  const u32 rate = sample_rate.load(std::memory_order_relaxed);
+
+  if (rate != 0 && ++heap->sample_counter >= rate) [[unlikely]] {
+    heap->sample_counter = 0;
+    record_site(size, tag);
+  }
+
+  return header + 1;
+}
+
+static usize resolve_tag(const MemoryTag tag) {
+  return static_cast<usize>(tag != MemoryTag::GENERAL ? tag : thread_tag);
+}
+
+void *aligned_alloc_16(usize size, const MemoryTag tag) { return alloc_tagged(size, resolve_tag(tag)); }
+
+void aligned_free_16(void *value) {
+  if (value == nullptr) {
+    return;
+  }
+
+  // may run after the thread gave up its heap, then every free is remote
+  Heap *heap = thread_heap;
+
+  Header *header = get_header(value);
+
+  count(header->span->heap, header->tag, -1, -static_cast<i64>(header->size));
+
+  if (is_large(header)) {
+    free_large(header);
+  } else {
+    free_small(heap, header->span, static_cast<FreeSlot *>(value));
+  }
+}
+
+void *aligned_realloc_16(void *old_memory, usize size, const MemoryTag tag) {
+  if (size == 0) {
+    aligned_free_16(old_memory);
+    return nullptr;
+  }
+
+  if (old_memory == nullptr) {
+    return aligned_alloc_16(size, tag);
+  }
+
+  Header *header = get_header(old_memory);
+  const usize old_size = header->size;
+
+  // stb_ds grows geometrically, the slot or the slack of the last growth often has room already. shrinking by more
+  // than half moves to give the memory back
+  if (size <= old_size && size > old_size / 2) {
+    return old_memory;
+  }
+
+  const usize block_size = align_size(size) + sizeof(Header);
+
+  if (is_large(header) && block_size > max_slot_size) {
+    if (Header *resized = realloc_large(header, block_size)) {
+      count(resized->span->heap, resized->tag, 0, static_cast<i64>(resized->size) - static_cast<i64>(old_size));
+
+      return resized + 1;
+    }
+  }
+
+  void *new_memory = alloc_tagged(size, header->tag);
+
+  memcpy(new_memory, old_memory, std::min(old_size, size));
   aligned_free_16(old_memory);
 
   return new_memory;
+}
+
+MemoryTag set_memory_tag(const MemoryTag tag) {
+  const MemoryTag previous = thread_tag;
+  thread_tag = tag;
+
+  return previous;
+}
+
+// telemetry
+
+struct TagTotals {
+  i64 blocks;
+  i64 bytes;
+  u64 allocs;
+
+  // sum of the heaps' high water marks
+  i64 peak_bytes;
+};
+
+static TagTotals get_totals(const usize tag) {
+  TagTotals totals = {};
+
+  const std::lock_guard lock(heaps_mutex);
+
+  for (const Heap *heap = all_heaps; heap != nullptr; heap = heap->next_heap) {
+    const TagCounters &counters = heap->counters[tag];
+
+    totals.blocks +=
+        counters.blocks.load(std::memory_order_relaxed) + counters.remote_blocks.load(std::memory_order_relaxed);
+    totals.bytes +=
+        counters.bytes.load(std::memory_order_relaxed) + counters.remote_bytes.load(std::memory_order_relaxed);
+    totals.allocs += counters.allocs.load(std::memory_order_relaxed);
+    totals.peak_bytes += counters.peak_bytes.load(std::memory_order_relaxed);
+  }
+
+  return totals;
+}
+
+static std::mutex stats_mutex;
+static MemoryStats tag_stats[tag_count];
+
+// allocs at the start of the current frame
+static u64 frame_start_allocs[tag_count];
+
+static void update_stats(const usize tag, const TagTotals &totals) {
+  MemoryStats &stats = tag_stats[tag];
+
+  // a block counted as allocated by one thread and freed by another can be caught half way
+  stats.live_blocks = static_cast<usize>(std::max<i64>(totals.blocks, 0));
+  stats.live_bytes = static_cast<usize>(std::max<i64>(totals.bytes, 0));
+  stats.peak_bytes = std::max({stats.peak_bytes, stats.live_bytes, static_cast<usize>(totals.peak_bytes)});
+  stats.total_allocs = totals.allocs;
+}
+
+static void close_stats_frame() {
+  const std::lock_guard lock(stats_mutex);
+
+  for (usize tag = 0; tag < tag_count; tag++) {
+    const TagTotals totals = get_totals(tag);
+
+    update_stats(tag, totals);
+
+    tag_stats[tag].frame_allocs = totals.allocs - frame_start_allocs[tag];
+    frame_start_allocs[tag] = totals.allocs;
+  }
+}
+
+MemoryStats get_memory_stats(const MemoryTag tag) {
+  const usize index = static_cast<usize>(tag);
+
+  const std::lock_guard lock(stats_mutex);
+
+  update_stats(index, get_totals(index));
+
+  return tag_stats[index];
+}
+
+const c8 *get_memory_tag_name(const MemoryTag tag) {
+  constexpr const c8 *names[] = {"general", "containers", "assets", "renderer", "physics", "ecs"};
+  static_assert(std::size(names) == tag_count);
+
+  return names[static_cast<usize>(tag)];
+}
+
+void set_alloc_sampling(const u32 every_nth) { sample_rate.store(every_nth, std::memory_order_relaxed); }
+
+// report lines go to the log or a file
+using ReportLine = void (*)(void *user, const c8 *line);
+
+static void write_report(const ReportLine line, void *user, const usize max_report_sites) {
+  c8 text[512];
+
+  snprintf(text, sizeof(text), "%-12s %12s %12s %10s %12s %14s", "tag", "live KiB", "peak KiB", "blocks",
+           "allocs/frame", "allocs");
+  line(user, text);
+
+  MemoryStats total = {};
+
+  for (usize tag = 0; tag < tag_count; tag++) {
+    const MemoryStats stats = get_memory_stats(static_cast<MemoryTag>(tag));
+
+    snprintf(text, sizeof(text), "%-12s %12.1f %12.1f %10zu %12llu %14llu",
+             get_memory_tag_name(static_cast<MemoryTag>(tag)), stats.live_bytes / 1024.0, stats.peak_bytes / 1024.0,
+             stats.live_blocks, static_cast<unsigned long long>(stats.frame_allocs),
+             static_cast<unsigned long long>(stats.total_allocs));
+    line(user, text);
+
+    total.live_bytes += stats.live_bytes;
+    total.live_blocks += stats.live_blocks;
+    total.frame_allocs += stats.frame_allocs;
+    total.total_allocs += stats.total_allocs;
+  }
+
+  snprintf(text, sizeof(text), "%-12s %12.1f %12s %10zu %12llu %14llu", "total", total.live_bytes / 1024.0, "",
+           total.live_blocks, static_cast<unsigned long long>(total.frame_allocs),
+           static_cast<unsigned long long>(total.total_allocs));
+  line(user, text);
+
+  const u32 rate = sample_rate.load(std::memory_order_relaxed);
+
+  if (rate == 0) {
+    return;
+  }
+
+  const std::lock_guard lock(sites_mutex);
+
+  const Site *order[max_sites];
+  usize order_count = 0;
+
+  for (const Site &site : sites) {
+    if (site.samples != 0) {
+      order[order_count++] = &site;
+    }
+  }
+
+  std::sort(order, order + order_count, [](const Site *a, const Site *b) { return a->bytes > b->bytes; });
+
+  snprintf(text, sizeof(text), "sampled sites, 1 in %u allocations, %zu sites, %llu samples dropped", rate,
+           order_count, static_cast<unsigned long long>(dropped_samples));
+  line(user, text);
+
+  for (usize i_site = 0; i_site < std::min(order_count, max_report_sites); i_site++) {
+    const Site &site = *order[i_site];
+
+    snprintf(text, sizeof(text), "#%zu %s, ~%llu allocations, ~%.1f KiB", i_site,
+             get_memory_tag_name(site.tag), static_cast<unsigned long long>(site.samples * rate),
+             static_cast<f64>(site.bytes) * rate / 1024.0);
+    line(user, text);
+
+#ifdef __linux__
+    c8 **symbols = backtrace_symbols(site.frames, static_cast<i32>(site.frame_count));
+
+    for (u32 i_frame = 0; i_frame < site.frame_count; i_frame++) {
+      snprintf(text, sizeof(text), "    %s", symbols != nullptr ? symbols[i_frame] : "?");
+      line(user, text);
+    }
+
+    free(symbols);
 #endif
+  }
+}
+
+// the log only shows the heaviest sites
+constexpr usize logged_sites = 8;
+
+void report_memory() {
+  LOG_INFO("memory:")
+
+  write_report([](void *, const c8 *line) { LOG_INFO("  %s", line) }, nullptr, logged_sites);
 }
 
-void assert_no_leaks() { LOG_ASSERT(alloc_counter == 0); }
+Result write_memory_report(const c8 *path) {
+  FILE *file = fopen(path, "w");
+
+  if (file == nullptr) {
+    return Result::error("failed to open the memory report");
+  }
+
+  write_report([](void *user, const c8 *line) { fprintf(static_cast<FILE *>(user), "%s\n", line); }, file,
+               max_sites);
+
+  fclose(file);
+
+  LOG_INFO("wrote memory report to %s", path)
+
+  return Result::ok();
+}
+
+void assert_no_leaks() {
+  i64 live = 0;
+
+  for (usize tag = 0; tag < tag_count; tag++) {
+    // the world is a static, so flecs' blocks are only freed after the check
+    if (tag != static_cast<usize>(MemoryTag::ECS)) {
+      live += get_totals(tag).blocks;
+    }
+  }
+
+  LOG_ASSERT(live == 0);
+}
+
+// arena
+
+struct Arena::Block {
+  Block *previous;
+  usize capacity;
+  usize used;
+};
+
+// rounded up, so the payload stays 16 byte aligned
+constexpr usize block_header_size = align_size(sizeof(Arena::Block));
+
+static u8 *get_block_data(Arena::Block *block) { return reinterpret_cast<u8 *>(block) + block_header_size; }
+
+Arena::~Arena() { LOG_ASSERT(_current == nullptr); }
+
+void *Arena::alloc(const usize size) {
+  const usize aligned_size = align_size(std::max<usize>(size, 1));
+
+  if (_current == nullptr || _current->capacity - _current->used < aligned_size) {
+    const usize capacity = std::max(_block_size, aligned_size);
+
+    Block *block = static_cast<Block *>(aligned_alloc_16(block_header_size + capacity));
+
+    *block = {.previous = _current, .capacity = capacity, .used = 0};
+    _current = block;
+  }
+
+  void *memory = get_block_data(_current) + _current->used;
+  _current->used += aligned_size;
+
+  return memory;
+}
+
+void *Arena::realloc(void *memory, const usize old_size, const usize new_size) {
+  if (memory == nullptr) {
+    return alloc(new_size);
+  }
+
+  const usize old_aligned = align_size(std::max<usize>(old_size, 1));
+  const usize new_aligned = align_size(std::max<usize>(new_size, 1));
+
+  const bool is_last = static_cast<u8 *>(memory) + old_aligned == get_block_data(_current) + _current->used;
+
+  if (is_last && _current->used - old_aligned + new_aligned <= _current->capacity) {
+    _current->used = _current->used - old_aligned + new_aligned;
+    return memory;
+  }
+
+  if (new_aligned <= old_aligned) {
+    return memory;
+  }
+
+  void *new_memory = alloc(new_size);
+  memcpy(new_memory, memory, old_size);
+
+  return new_memory;
+}
+
+Arena::Marker Arena::get_marker() const { return {.block = _current, .used = _current != nullptr ? _current->used : 0}; }
+
+void Arena::rewind(const Marker marker) {
+  while (_current != marker.block) {
+    Block *previous = _current->previous;
+
+    aligned_free_16(_current);
+    _current = previous;
+  }
+
+  if (_current != nullptr) {
+    _current->used = marker.used;
+  }
+}
+
+void Arena::reset() {
+  if (_current == nullptr) {
+    return;
+  }
+
+  if (_current->previous == nullptr) {
+    _current->used = 0;
+    return;
+  }
+
+  const usize capacity = get_capacity();
+
+  release();
+
+  _current = static_cast<Block *>(aligned_alloc_16(block_header_size + capacity));
+  *_current = {.previous = nullptr, .capacity = capacity, .used = 0};
+}
+
+void Arena::release() { rewind({.block = nullptr, .used = 0}); }
+
+usize Arena::get_used() const {
+  usize used = 0;
+
+  for (const Block *block = _current; block != nullptr; block = block->previous) {
+    used += block->used;
+  }
+
+  return used;
+}
+
+usize Arena::get_capacity() const {
+  usize capacity = 0;
+
+  for (const Block *block = _current; block != nullptr; block = block->previous) {
+    capacity += block->capacity;
+  }
+
+  return capacity;
+}
+
+// frame arenas
+
+static Arena frame_arenas[2];
+static usize frame_index = 0;
+
+Arena &get_frame_arena() { return frame_arenas[frame_index]; }
+
+void next_frame() {
+  frame_index = (frame_index + 1) % 2;
+  frame_arenas[frame_index].reset();
+
+  close_stats_frame();
+}
+
+void release_frame_arenas() {
+  for (Arena &arena : frame_arenas) {
+    arena.release();
+  }
+}
 
 } // namespace utils
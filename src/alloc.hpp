@@ -2,19 +2,137 @@
 
 #include "types.hpp"
 
-#define STBDS_REALLOC(context, ptr, size) utils::aligned_realloc_16(ptr, size)
+#define STBDS_REALLOC(context, ptr, size) utils::aligned_realloc_16(ptr, size, utils::MemoryTag::CONTAINERS)
 #define STBDS_FREE(context, ptr) utils::aligned_free_16(ptr)
 
 namespace utils {
 
+struct Result;
+
 // allocator
 
-void *aligned_alloc_16(usize size);
+// the subsystem a block is counted for. a tag the call passes wins, GENERAL calls are counted for the innermost
+// MemoryTagScope of the allocating thread. a block keeps its tag through reallocs
+enum class MemoryTag : u8 {
+  GENERAL,
+  CONTAINERS,
+  ASSETS,
+  RENDERER,
+  PHYSICS,
+  ECS,
+  COUNT,
+};
+
+void *aligned_alloc_16(usize size, const MemoryTag tag = MemoryTag::GENERAL);
 
 void aligned_free_16(void *value);
 
-void *aligned_realloc_16(void *old_memory, usize size);
+void *aligned_realloc_16(void *old_memory, usize size, const MemoryTag tag = MemoryTag::GENERAL);
 
+// ECS is left out, the world outlives the check
 void assert_no_leaks();
 
+// returns the previous tag of the calling thread
+MemoryTag set_memory_tag(const MemoryTag tag);
+
+struct MemoryTagScope {
+  const MemoryTag previous;
+
+  explicit MemoryTagScope(const MemoryTag tag) : previous(set_memory_tag(tag)) {}
+  ~MemoryTagScope() { set_memory_tag(previous); }
+  MemoryTagScope(const MemoryTagScope &) = delete;
+};
+
+// telemetry
+
+struct MemoryStats {
+  usize live_bytes;
+  usize live_blocks;
+
+  // sum of every thread's high water mark, blocks that peaked at different times can add up above the real peak
+  usize peak_bytes;
+
+  // allocations in the last finished frame
+  u64 frame_allocs;
+  u64 total_allocs;
+};
+
+[[nodiscard]] MemoryStats get_memory_stats(const MemoryTag tag);
+
+[[nodiscard]] const c8 *get_memory_tag_name(const MemoryTag tag);
+
+// records the call stack of every nth allocation of each thread for the site list of the report, 0 turns it off.
+// stacks are only captured on linux
+void set_alloc_sampling(const u32 every_nth);
+
+// logs the tags and the top sampled allocation sites
+void report_memory();
+
+// the same with every sampled site
+Result write_memory_report(const c8 *path);
+
+// arena
+
+constexpr usize default_arena_block_size = 64 * 1024;
+
+// bump allocator over a chain of blocks, memory is only given back all at once by reset or up to a marker by rewind.
+// not thread safe, every thread or job uses its own
+struct Arena {
+  struct Block;
+
+  struct Marker {
+    Block *block;
+    usize used;
+  };
+
+private:
+  Block *_current = nullptr;
+  usize _block_size;
+
+public:
+  explicit Arena(const usize block_size = default_arena_block_size) : _block_size(block_size) {}
+  ~Arena();
+  Arena(const Arena &) = delete;
+  Arena(Arena &&) = delete;
+
+  // 16 byte aligned like aligned_alloc_16
+  [[nodiscard]] void *alloc(const usize size);
+
+  // grows the latest allocation in place if it still fits its block, copies otherwise
+  [[nodiscard]] void *realloc(void *memory, const usize old_size, const usize new_size);
+
+  [[nodiscard]] Marker get_marker() const;
+
+  // frees everything allocated after the marker was taken
+  void rewind(const Marker marker);
+
+  // keeps the memory, blocks are merged into one so the next cycle needs no heap allocation
+  void reset();
+
+  void release();
+
+  [[nodiscard]] usize get_used() const;
+  [[nodiscard]] usize get_capacity() const;
+};
+
+// rewinds the arena when leaving the scope
+struct ArenaScope {
+  Arena &arena;
+  const Arena::Marker marker;
+
+  explicit ArenaScope(Arena &scope_arena) : arena(scope_arena), marker(scope_arena.get_marker()) {}
+  ~ArenaScope() { arena.rewind(marker); }
+  ArenaScope(const ArenaScope &) = delete;
+};
+
+// double buffered on the main thread, what a frame allocates stays valid through the next one
+
+[[nodiscard]] Arena &get_frame_arena();
+
+// at the start of every frame, resets the arena of the frame before the last one and closes the frame of the memory
+// stats
+void next_frame();
+
+void release_frame_arenas();
+
 } // namespace utils
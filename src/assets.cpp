@@ -1,16 +1,28 @@
 #include "assets.hpp"
+#include "cooked.hpp"
 #include "engine.hpp"
+#include "geometry.hpp"
+#include "jobs.hpp"
 #include "renderer.hpp"
 #include "thirdparty/cgltf/cgltf.h"
+#include "thirdparty/sokol/sokol_fetch.h"
+#include "thirdparty/sokol/sokol_log.h"
 #include "world.hpp"
+#include <atomic>
+#include <cmath>
+#include <cstring>
 #include <limits>
+#include <thread>
 
 namespace assets {
 
-utils::DSArray<utils::Owner<assets::Prefab>> prefabs;
+// Vertices and Indices are DSArray or ArenaArray of Vertex and u32
+template <typename Vertices, typename Indices>
+utils::Result parse_prim(const cgltf_primitive &gltf_prim, Vertices &vertices, Indices &indices, comps::Mesh &out_mesh) {
+  if (gltf_prim.type != cgltf_primitive_type_triangles) {
+    return utils::Result::error("gltf_prim.type != cgltf_primitive_type_triangles");
+  }
 
-utils::Result parse_prim(const cgltf_primitive &gltf_prim, utils::DSArray<comps::MeshBuffer::Vertex> &vertices,
-                         utils::DSArray<comps::MeshBuffer::IndexType> &indices, comps::Mesh &out_mesh) {
   cgltf_attribute position_attrib = {};
   cgltf_attribute normal_attrib = {};
   cgltf_attribute texcoord_attrib = {};
@@ -41,8 +53,8 @@ utils::Result parse_prim(const cgltf_primitive &gltf_prim, utils::DSArray<comps:
   const usize last_vertices_len = vertices.size();
   const usize new_vertices_len = last_vertices_len + position_attrib.data->count;
 
-  if (new_vertices_len >= std::numeric_limits<comps::MeshBuffer::IndexType>::max()) {
-    return utils::Result::error("new_vertices_len > std::numeric_limits<int>::max()");
+  if (new_vertices_len > std::numeric_limits<u32>::max()) {
+    return utils::Result::error("new_vertices_len > std::numeric_limits<u32>::max()");
   }
 
   if (position_attrib.data->count != normal_attrib.data->count ||
@@ -51,150 +63,1179 @@ utils::Result parse_prim(const cgltf_primitive &gltf_prim, utils::DSArray<comps:
         "pos_attrib.data->count != normal_attrib.data->count || pos_attrib.data->count != uv_attrib.data->count");
   }
 
-  vertices.resize(new_vertices_len);
-
-  for (cgltf_size i_component = 0; i_component < position_attrib.data->count; i_component++) {
-    comps::MeshBuffer::Vertex vertex;
-
-    constexpr usize tmp_count = 3;
-    f32 tmp[tmp_count];
+  // unindexed primitives draw every vertex in order
+  const cgltf_accessor *index_access = gltf_prim.indices;
+  const usize index_count = index_access != nullptr ? index_access->count : position_attrib.data->count;
 
-    LOG_ASSERT(cgltf_accessor_read_float(position_attrib.data, i_component, tmp, tmp_count));
-    vertex.position[0] = tmp[0];
-    vertex.position[1] = tmp[1];
-    vertex.position[2] = tmp[2];
+  if (index_count % 3 != 0) {
+    return utils::Result::error("index_count % 3 != 0");
+  }
 
-    LOG_ASSERT(cgltf_accessor_read_float(normal_attrib.data, i_component, tmp, tmp_count));
-    vertex.normal[0] = tmp[0];
-    vertex.normal[1] = tmp[1];
-    vertex.normal[2] = tmp[2];
+  vertices.resize(new_vertices_len);
 
-    LOG_ASSERT(cgltf_accessor_read_float(texcoord_attrib.data, i_component, tmp, tmp_count));
-    vertex.uv[0] = tmp[0];
-    vertex.uv[1] = tmp[1];
+  HMM_Vec3 bounds_min;
+  HMM_Vec3 bounds_max;
 
-    vertices[last_vertices_len + i_component] = vertex;
-  }
+  const geometry::VertexAccessors accessors = {
+      .position = position_attrib.data,
+      .normal = normal_attrib.data,
+      .texcoord = texcoord_attrib.data,
+  };
 
-  const cgltf_accessor *index_access = gltf_prim.indices;
+  geometry::unpack_vertices(accessors, vertices.data() + last_vertices_len, bounds_min, bounds_max);
 
   const usize last_indices_len = indices.size();
-  const usize new_indices_len = last_indices_len + index_access->count;
+  const usize new_indices_len = last_indices_len + index_count;
 
   indices.resize(new_indices_len);
 
-  for (cgltf_size i_index = 0; i_index < index_access->count; i_index++) {
-    comps::MeshBuffer::IndexType index =
-        static_cast<comps::MeshBuffer::IndexType>(cgltf_accessor_read_index(index_access, i_index));
+  // rebased onto the shared vertex array, sg_draw has no base vertex
+  if (index_access != nullptr) {
+    geometry::unpack_indices(index_access, static_cast<u32>(last_vertices_len), indices.data() + last_indices_len);
+  } else {
+    for (usize i = 0; i < index_count; i++) {
+      indices[last_indices_len + i] = static_cast<u32>(last_vertices_len + i);
+    }
+  }
+
+  // the optimization passes index host arrays with these, an index past the primitive's vertices is rejected before
+  // any of them runs. one that wrapped in the rebase ends up below the first vertex
+  for (usize i = last_indices_len; i < new_indices_len; i++) {
+    if (indices[i] < last_vertices_len || indices[i] >= new_vertices_len) {
+      vertices.resize(last_vertices_len);
+      indices.resize(last_indices_len);
+
+      return utils::Result::error("gltf index out of range");
+    }
+  }
 
-    indices[last_indices_len + i_index] = index;
+  // prefer the exporter's accessor bounds, they are required by the spec for POSITION
+  if (position_attrib.data->has_min && position_attrib.data->has_max) {
+    bounds_min = HMM_V3(position_attrib.data->min[0], position_attrib.data->min[1], position_attrib.data->min[2]);
+    bounds_max = HMM_V3(position_attrib.data->max[0], position_attrib.data->max[1], position_attrib.data->max[2]);
   }
 
-  out_mesh = {.base_vertex = (comps::MeshBuffer::IndexType)last_indices_len,
-              .index_count = (comps::MeshBuffer::IndexType)index_access->count};
+  const HMM_Vec3 extents = (bounds_max - bounds_min) * 0.5f;
+
+  out_mesh = {.base_element = static_cast<u32>(last_indices_len),
+              .index_count = static_cast<u32>(index_count),
+              .bounds = {
+                  .center = (bounds_min + bounds_max) * 0.5f,
+                  .extents = extents,
+                  .radius = HMM_LenV3(extents),
+              }};
 
   return utils::Result::ok();
 }
 
-assets::Prefab::Node parse_node(const cgltf_node *gltf_node, utils::DSStringMap<comps::Mesh> &mesh_map) {
-  comps::Transform transform = {};
+// every primitive of a gltf mesh becomes one entry of the mesh table
+struct MeshRange {
+  i32 first;
+  u32 count;
+};
+
+// appends the node and its subtree in pre-order, so every parent comes before its children. primitives after the
+// first one go to child nodes without their own transform. out_matrices gets the full local matrix of every node,
+// including the scale the nodes can't hold
+template <typename Nodes>
+void parse_node_tree(const cgltf_data *data, const cgltf_node *gltf_node, const i32 parent,
+                     const utils::ArenaArray<MeshRange> &mesh_table, Nodes &out_nodes,
+                     utils::ArenaArray<HMM_Mat4> *out_matrices) {
+  CookedNode node = {
+      .translation = HMM_V3(0.0f, 0.0f, 0.0f),
+      .rotation = HMM_Q(0.0f, 0.0f, 0.0f, 1.0f),
+      .mesh = -1,
+      .parent = parent,
+  };
+
+  if (gltf_node->has_matrix) {
+    // LocalTransform has no scale, so the basis is normalized and only the rotation is kept
+    HMM_Mat4 matrix;
+    memcpy(&matrix, gltf_node->matrix, sizeof(matrix));
+
+    for (usize i_column = 0; i_column < 3; i_column++) {
+      matrix.Columns[i_column].XYZ = HMM_NormV3(matrix.Columns[i_column].XYZ);
+    }
+
+    node.translation = matrix.Columns[3].XYZ;
+    node.rotation = HMM_M4ToQ_RH(matrix);
+  }
 
   if (gltf_node->has_translation) {
-    transform.translation = HMM_V3(gltf_node->translation[0], gltf_node->translation[1], gltf_node->translation[2]);
+    node.translation = HMM_V3(gltf_node->translation[0], gltf_node->translation[1], gltf_node->translation[2]);
   }
 
   if (gltf_node->has_rotation) {
-    transform.rotation =
+    node.rotation =
         HMM_Q(gltf_node->rotation[0], gltf_node->rotation[1], gltf_node->rotation[2], gltf_node->rotation[3]);
   }
 
-  assets::Prefab::Node node = {
-      .transform = transform,
-  };
+  MeshRange range = {.first = -1, .count = 0};
 
   if (gltf_node->mesh) {
-    const utils::DSStringMap<comps::Mesh>::Item *mesh_kv = mesh_map.get_or_null(gltf_node->mesh->name);
+    range = mesh_table[cgltf_mesh_index(data, gltf_node->mesh)];
+  }
+
+  if (range.count > 0) {
+    node.mesh = range.first;
+  }
+
+  const i32 node_index = static_cast<i32>(out_nodes.size());
+
+  out_nodes.emplace_back(std::move(node));
+
+  if (out_matrices != nullptr) {
+    HMM_Mat4 matrix;
+    cgltf_node_transform_local(gltf_node, &matrix.Elements[0][0]);
+
+    out_matrices->emplace_back(std::move(matrix));
+  }
+
+  for (u32 i_prim = 1; i_prim < range.count; i_prim++) {
+    out_nodes.emplace_back(CookedNode{
+        .translation = HMM_V3(0.0f, 0.0f, 0.0f),
+        .rotation = HMM_Q(0.0f, 0.0f, 0.0f, 1.0f),
+        .mesh = range.first + static_cast<i32>(i_prim),
+        .parent = node_index,
+    });
+
+    if (out_matrices != nullptr) {
+      out_matrices->emplace_back(HMM_M4D(1.0f));
+    }
+  }
+
+  for (cgltf_size i_child = 0; i_child < gltf_node->children_count; i_child++) {
+    parse_node_tree(data, gltf_node->children[i_child], node_index, mesh_table, out_nodes, out_matrices);
+  }
+}
+
+// uploads the payloads and copies the tables, the model's views aren't needed afterwards
+utils::Owner<assets::Prefab> make_prefab(const CookedModel &model) {
+  utils::Owner<assets::Prefab> prefab = utils::Owner<assets::Prefab>::make();
 
-    if (mesh_kv) {
-      node.mesh = mesh_kv->value;
+  prefab->meshbuffer = renderer::upload_meshbuffer(
+      sg_range{
+          .ptr = model.vertices,
+          .size = model.vertex_count * comps::MeshBuffer::get_vertex_size(model.vertex_format),
+      },
+      sg_range{.ptr = model.indices, .size = model.index_count * comps::MeshBuffer::get_index_size(model.index_format)},
+      model.vertex_format, model.index_format);
+
+  for (u32 i_node = 0; i_node < model.node_count; i_node++) {
+    const CookedNode &cooked_node = model.nodes[i_node];
+
+    assets::Prefab::Node node = {
+        .transform = {.translation = cooked_node.translation, .rotation = cooked_node.rotation},
+        .parent = cooked_node.parent,
+    };
+
+    if (cooked_node.mesh >= 0) {
+      node.mesh = model.meshes[cooked_node.mesh];
       node.has_mesh = true;
     }
+
+    prefab->nodes.emplace_back(std::move(node));
   }
 
-  return node;
+  return prefab;
 }
 
-utils::Result load_model(const c8 *path, utils::NonOwner<assets::Prefab> &out_prefab) {
-  out_prefab.reset();
+// the mesh has to be the last one in vertices, which shrink if vertices were merged
+void optimize_mesh(const c8 *name, utils::DSArray<comps::MeshBuffer::Vertex> &vertices, utils::DSArray<u32> &indices,
+                   const usize first_vertex, const comps::Mesh &mesh) {
+  comps::MeshBuffer::Vertex *mesh_vertices = &vertices[first_vertex];
+  u32 *mesh_indices = &indices[mesh.base_element];
 
-  cgltf_options options = {};
-  cgltf_data *data = NULL;
-  cgltf_result result = cgltf_parse_file(&options, path, &data);
+  const usize index_count = mesh.index_count;
+  usize vertex_count = vertices.size() - first_vertex;
 
-  if (result != cgltf_result_success) {
-    return utils::Result::error("can't open gltf file");
+  // the passes work on mesh local indices
+  for (usize i = 0; i < index_count; i++) {
+    mesh_indices[i] -= static_cast<u32>(first_vertex);
   }
 
-  result = cgltf_load_buffers(&options, data, path);
+  const geometry::VertexCacheStats before = geometry::analyze_vertex_cache(mesh_indices, index_count, vertex_count);
+  const usize vertex_count_before = vertex_count;
+
+  vertex_count = geometry::deduplicate_vertices(mesh_vertices, vertex_count, mesh_indices, index_count);
+  geometry::optimize_vertex_cache(mesh_indices, index_count, vertex_count);
+  geometry::optimize_overdraw(mesh_indices, index_count, mesh_vertices, vertex_count);
+  vertex_count = geometry::optimize_vertex_fetch(mesh_vertices, vertex_count, mesh_indices, index_count);
 
-  if (result != cgltf_result_success) {
-    cgltf_free(data);
+  const geometry::VertexCacheStats after = geometry::analyze_vertex_cache(mesh_indices, index_count, vertex_count);
 
-    return utils::Result::error("can't open gltf buffers");
+  LOG_INFO("%s: acmr %.3f -> %.3f, atvr %.3f -> %.3f, vertices %zu -> %zu", name, before.acmr, after.acmr,
+           before.atvr, after.atvr, vertex_count_before, vertex_count)
+
+  for (usize i = 0; i < index_count; i++) {
+    mesh_indices[i] += static_cast<u32>(first_vertex);
+  }
+
+  vertices.resize(first_vertex + vertex_count);
+}
+
+// stops before a level would go below this, too small for the saving to matter
+constexpr usize min_lod_triangles = 32;
+
+// appends coarser index lists behind the mesh's own, every level aims for half the triangles of the one before
+void generate_lods(const c8 *name, utils::Arena &scratch, const utils::DSArray<comps::MeshBuffer::Vertex> &vertices,
+                   utils::DSArray<u32> &indices, const usize first_vertex, comps::Mesh &mesh) {
+  const utils::ArenaScope scope(scratch);
+
+  const comps::MeshBuffer::Vertex *mesh_vertices = &vertices[first_vertex];
+  const usize vertex_count = vertices.size() - first_vertex;
+
+  utils::ArenaArray<u32> source(scratch);
+  source.resize(mesh.index_count);
+
+  utils::ArenaArray<u32> simplified(scratch);
+  simplified.resize(mesh.index_count);
+
+  for (usize i = 0; i < mesh.index_count; i++) {
+    source[i] = indices[mesh.base_element + i] - static_cast<u32>(first_vertex);
   }
 
+  usize source_count = mesh.index_count;
+  f32 error = 0.0f;
+
+  mesh.lod_count = 0;
+
+  while (mesh.lod_count < comps::Mesh::max_lods) {
+    const usize target_count = source_count / 6 * 3;
+
+    if (target_count < min_lod_triangles * 3) {
+      break;
+    }
+
+    f32 lod_error = 0.0f;
+    const usize lod_index_count = geometry::simplify(source.data(), source_count, mesh_vertices, vertex_count,
+                                                     target_count, simplified.data(), lod_error);
+
+    // locked borders can stall the simplifier, a level that barely shrinks isn't worth its indices
+    if (lod_index_count * 4 > source_count * 3) {
+      break;
+    }
+
+    geometry::optimize_vertex_cache(simplified.data(), lod_index_count, vertex_count);
+
+    // every level is simplified from the previous one, so the errors add up
+    error += lod_error;
+
+    const usize base_element = indices.size();
+
+    mesh.lods[mesh.lod_count++] = {
+        .base_element = static_cast<u32>(base_element),
+        .index_count = static_cast<u32>(lod_index_count),
+        .error = error,
+    };
+
+    indices.resize(base_element + lod_index_count);
+
+    for (usize i = 0; i < lod_index_count; i++) {
+      indices[base_element + i] = simplified[i] + static_cast<u32>(first_vertex);
+    }
+
+    memcpy(source.data(), simplified.data(), lod_index_count * sizeof(u32));
+    source_count = lod_index_count;
+  }
+
+  LOG_INFO("%s: %u lods, triangles %u -> %u", name, mesh.lod_count, mesh.index_count / 3,
+           static_cast<u32>(source_count / 3))
+}
+
+// output of decoding a gltf file in cooked layout
+struct DecodedModel {
+  comps::MeshBuffer::VertexFormat vertex_format;
+  bool flattened;
+
+  // float vertices are always decoded, the quantized ones are converted from them
   utils::DSArray<comps::MeshBuffer::Vertex> vertices;
-  utils::DSArray<comps::MeshBuffer::IndexType> indices;
+  utils::DSArray<comps::MeshBuffer::QuantizedVertex> quantized_vertices;
+
+  comps::MeshBuffer::IndexFormat index_format;
+
+  // decoded as u32 and narrowed if the vertices fit
+  utils::DSArray<u32> indices;
+  utils::DSArray<u16> narrow_indices;
+
+  utils::DSArray<comps::Mesh> meshes;
+  utils::DSArray<CookedNode> nodes;
+
+  u64 source_hash;
+
+  [[nodiscard]] CookedModel view() const {
+    const bool quantized = vertex_format == comps::MeshBuffer::VertexFormat::QUANTIZED;
+
+    return {
+        .vertices = quantized ? static_cast<const void *>(quantized_vertices.data()) : vertices.data(),
+        .vertex_count = static_cast<u32>(vertices.size()),
+        .vertex_format = vertex_format,
+        .flattened = flattened,
+        .indices = index_format == comps::MeshBuffer::IndexFormat::U16 ? static_cast<const void *>(narrow_indices.data())
+                                                                        : indices.data(),
+        .index_count = static_cast<u32>(indices.size()),
+        .index_format = index_format,
+        .meshes = meshes.data(),
+        .mesh_count = static_cast<u32>(meshes.size()),
+        .nodes = nodes.data(),
+        .node_count = static_cast<u32>(nodes.size()),
+        .source_hash = source_hash,
+    };
+  }
+
+  void release() {
+    vertices.release();
+    quantized_vertices.release();
+    indices.release();
+    narrow_indices.release();
+    meshes.release();
+    nodes.release();
+  }
+};
+
+// most models' temporaries fit the first block
+constexpr usize decode_arena_block_size = 4 * 1024 * 1024;
+
+// room for the source path and the mesh it is logging about
+constexpr usize mesh_name_size = cooked_path_size + 64;
+
+// pre-order nodes of the default scene, without one every root node is imported
+template <typename Nodes>
+void parse_scene(const cgltf_data *data, const utils::ArenaArray<MeshRange> &mesh_table, Nodes &out_nodes,
+                 utils::ArenaArray<HMM_Mat4> *out_matrices = nullptr) {
+  const cgltf_scene *scene = data->scene != nullptr ? data->scene : (data->scenes_count > 0 ? data->scenes : nullptr);
+
+  if (scene != nullptr) {
+    for (cgltf_size i_node = 0; i_node < scene->nodes_count; i_node++) {
+      parse_node_tree(data, scene->nodes[i_node], -1, mesh_table, out_nodes, out_matrices);
+    }
+  } else {
+    for (cgltf_size i_node = 0; i_node < data->nodes_count; i_node++) {
+      if (data->nodes[i_node].parent == nullptr) {
+        parse_node_tree(data, &data->nodes[i_node], -1, mesh_table, out_nodes, out_matrices);
+      }
+    }
+  }
+}
+
+// one optimized mesh per primitive and the node tree as it is in the file
+void decode_meshes(const c8 *path, const cgltf_data *data, utils::Arena &scratch, DecodedModel &out_model,
+                   utils::ArenaArray<usize> &out_first_vertex) {
+  // gltf mesh index to its primitives in the mesh table, failed primitives are left out
+  utils::ArenaArray<MeshRange> mesh_table(scratch);
+
+  for (cgltf_size i_mesh = 0; i_mesh < data->meshes_count; i_mesh++) {
+    const cgltf_mesh *gltf_mesh = &data->meshes[i_mesh];
+
+    MeshRange range = {.first = static_cast<i32>(out_model.meshes.size()), .count = 0};
+
+    for (cgltf_size i_prim = 0; i_prim < gltf_mesh->primitives_count; i_prim++) {
+      comps::Mesh mesh;
+      usize first_vertex = out_model.vertices.size();
+
+      if (parse_prim(gltf_mesh->primitives[i_prim], out_model.vertices, out_model.indices, mesh)) {
+        c8 name[mesh_name_size];
+        snprintf(name, sizeof(name), "%s mesh %zu/%zu", path, i_mesh, i_prim);
+
+        optimize_mesh(name, out_model.vertices, out_model.indices, first_vertex, mesh);
+        generate_lods(name, scratch, out_model.vertices, out_model.indices, first_vertex, mesh);
+
+        out_model.meshes.emplace_back(std::move(mesh));
+        out_first_vertex.emplace_back(std::move(first_vertex));
+        range.count++;
+      }
+    }
+
+    mesh_table.emplace_back(std::move(range));
+  }
 
-  comps::MeshBuffer meshbuffer = {};
+  parse_scene(data, mesh_table, out_model.nodes);
+}
 
-  utils::DSStringMap<comps::Mesh> mesh_map;
+// bakes every node's transform into its vertices and merges the primitives by material, so the model ends up as one
+// root node per material
+void decode_flattened(const c8 *path, const cgltf_data *data, utils::Arena &scratch, DecodedModel &out_model,
+                      utils::ArenaArray<usize> &out_first_vertex) {
+  // the primitives as they are in the file, optimized after merging
+  utils::ArenaArray<comps::MeshBuffer::Vertex> source_vertices(scratch);
+  utils::ArenaArray<u32> source_indices(scratch);
+  utils::ArenaArray<comps::Mesh> source_meshes(scratch);
+  utils::ArenaArray<usize> source_first_vertex(scratch);
+  utils::ArenaArray<i32> source_materials(scratch);
+  utils::ArenaArray<MeshRange> mesh_table(scratch);
 
   for (cgltf_size i_mesh = 0; i_mesh < data->meshes_count; i_mesh++) {
     const cgltf_mesh *gltf_mesh = &data->meshes[i_mesh];
 
-    if (gltf_mesh->primitives_count > 0) {
+    MeshRange range = {.first = static_cast<i32>(source_meshes.size()), .count = 0};
+
+    for (cgltf_size i_prim = 0; i_prim < gltf_mesh->primitives_count; i_prim++) {
+      const cgltf_primitive &gltf_prim = gltf_mesh->primitives[i_prim];
+
       comps::Mesh mesh;
+      usize first_vertex = source_vertices.size();
 
-      if (parse_prim(gltf_mesh->primitives[0], vertices, indices, mesh)) {
-        mesh_map.put(gltf_mesh->name, std::move(mesh));
+      if (parse_prim(gltf_prim, source_vertices, source_indices, mesh)) {
+        i32 material = gltf_prim.material != nullptr ? static_cast<i32>(cgltf_material_index(data, gltf_prim.material))
+                                                     : -1;
+
+        source_meshes.emplace_back(std::move(mesh));
+        source_first_vertex.emplace_back(std::move(first_vertex));
+        source_materials.emplace_back(std::move(material));
+        range.count++;
       }
     }
+
+    mesh_table.emplace_back(std::move(range));
   }
 
-  meshbuffer = renderer::upload_meshbuffer(
-      sg_range{.ptr = vertices.data(), .size = vertices.size() * sizeof(comps::MeshBuffer::Vertex)},
-      sg_range{.ptr = indices.data(), .size = indices.size() * sizeof(comps::MeshBuffer::IndexType)});
+  utils::ArenaArray<CookedNode> source_nodes(scratch);
+  utils::ArenaArray<HMM_Mat4> node_matrices(scratch);
 
-  vertices.release();
-  indices.release();
-  utils::Owner<assets::Prefab> prefab = utils::Owner<assets::Prefab>::make();
+  parse_scene(data, mesh_table, source_nodes, &node_matrices);
+
+  // local to relative to the prefab root, with scale since it ends up in the vertices. parents come first so theirs
+  // is always done
+  for (usize i_node = 0; i_node < source_nodes.size(); i_node++) {
+    const i32 parent = source_nodes[i_node].parent;
+
+    if (parent >= 0) {
+      node_matrices[i_node] = node_matrices[parent] * node_matrices[i_node];
+    }
+  }
+
+  // in order of first use, so the output follows the file
+  utils::ArenaArray<i32> materials(scratch);
+
+  for (usize i_node = 0; i_node < source_nodes.size(); i_node++) {
+    if (source_nodes[i_node].mesh < 0) {
+      continue;
+    }
+
+    i32 material = source_materials[source_nodes[i_node].mesh];
+    bool known = false;
+
+    for (usize i_material = 0; i_material < materials.size(); i_material++) {
+      known |= materials[i_material] == material;
+    }
+
+    if (!known) {
+      materials.emplace_back(std::move(material));
+    }
+  }
+
+  for (usize i_material = 0; i_material < materials.size(); i_material++) {
+    usize first_vertex = out_model.vertices.size();
+    const usize base_element = out_model.indices.size();
+
+    HMM_Vec3 bounds_min = HMM_V3(std::numeric_limits<f32>::max(), std::numeric_limits<f32>::max(),
+                                 std::numeric_limits<f32>::max());
+    HMM_Vec3 bounds_max = -bounds_min;
+
+    for (usize i_node = 0; i_node < source_nodes.size(); i_node++) {
+      const i32 source_mesh_index = source_nodes[i_node].mesh;
+
+      if (source_mesh_index < 0 || source_materials[source_mesh_index] != materials[i_material]) {
+        continue;
+      }
+
+      const comps::Mesh &source_mesh = source_meshes[source_mesh_index];
+      const usize source_first = source_first_vertex[source_mesh_index];
+      const usize source_end = static_cast<usize>(source_mesh_index) + 1 < source_meshes.size()
+                                   ? source_first_vertex[source_mesh_index + 1]
+                                   : source_vertices.size();
+
+      const HMM_Mat4 &matrix = node_matrices[i_node];
+
+      // normals take the inverse transpose, so non uniform scale keeps them perpendicular. a mirroring transform
+      // flips the winding as well
+      const f32 determinant = HMM_DeterminantM4(matrix);
+      const HMM_Mat4 normal_matrix = determinant != 0.0f ? HMM_TransposeM4(HMM_InvGeneralM4(matrix)) : matrix;
+
+      const usize vertex_offset = out_model.vertices.size();
+      out_model.vertices.resize(vertex_offset + source_end - source_first);
+
+      for (usize i_vertex = source_first; i_vertex < source_end; i_vertex++) {
+        const comps::MeshBuffer::Vertex &source = source_vertices[i_vertex];
+        comps::MeshBuffer::Vertex &vertex = out_model.vertices[vertex_offset + i_vertex - source_first];
+
+        const HMM_Vec3 position =
+            (matrix * HMM_V4(source.position[0], source.position[1], source.position[2], 1.0f)).XYZ;
+        const HMM_Vec3 scaled_normal =
+            (normal_matrix * HMM_V4(source.normal[0], source.normal[1], source.normal[2], 0.0f)).XYZ;
+        const f32 normal_length = HMM_LenV3(scaled_normal);
+        const HMM_Vec3 normal = normal_length > 0.0f ? scaled_normal / normal_length : scaled_normal;
+
+        vertex = source;
+
+        for (usize k = 0; k < 3; k++) {
+          vertex.position[k] = position.Elements[k];
+          vertex.normal[k] = normal.Elements[k];
+        }
+
+        bounds_min = HMM_V3(HMM_MIN(bounds_min.X, position.X), HMM_MIN(bounds_min.Y, position.Y),
+                            HMM_MIN(bounds_min.Z, position.Z));
+        bounds_max = HMM_V3(HMM_MAX(bounds_max.X, position.X), HMM_MAX(bounds_max.Y, position.Y),
+                            HMM_MAX(bounds_max.Z, position.Z));
+      }
+
+      const usize index_offset = out_model.indices.size();
+      out_model.indices.resize(index_offset + source_mesh.index_count);
+
+      for (usize i = 0; i < source_mesh.index_count; i++) {
+        out_model.indices[index_offset + i] =
+            source_indices[source_mesh.base_element + i] - static_cast<u32>(source_first) +
+            static_cast<u32>(vertex_offset);
+      }
+
+      if (determinant < 0.0f) {
+        for (usize i = index_offset; i + 2 < out_model.indices.size(); i += 3) {
+          std::swap(out_model.indices[i + 1], out_model.indices[i + 2]);
+        }
+      }
+    }
+
+    const HMM_Vec3 extents = (bounds_max - bounds_min) * 0.5f;
+
+    comps::Mesh mesh = {
+        .base_element = static_cast<u32>(base_element),
+        .index_count = static_cast<u32>(out_model.indices.size() - base_element),
+        .bounds =
+            {
+                .center = (bounds_min + bounds_max) * 0.5f,
+                .extents = extents,
+                .radius = HMM_LenV3(extents),
+            },
+    };
+
+    c8 name[mesh_name_size];
+    snprintf(name, sizeof(name), "%s material %d", path, materials[i_material]);
+
+    optimize_mesh(name, out_model.vertices, out_model.indices, first_vertex, mesh);
+    generate_lods(name, scratch, out_model.vertices, out_model.indices, first_vertex, mesh);
+
+    out_model.nodes.emplace_back(CookedNode{
+        .translation = HMM_V3(0.0f, 0.0f, 0.0f),
+        .rotation = HMM_Q(0.0f, 0.0f, 0.0f, 1.0f),
+        .mesh = static_cast<i32>(out_model.meshes.size()),
+        .parent = -1,
+    });
+
+    out_model.meshes.emplace_back(std::move(mesh));
+    out_first_vertex.emplace_back(std::move(first_vertex));
+  }
+}
+
+// thread safe, cooks the result next to path
+void decode_gltf(const c8 *path, const cgltf_data *data, const u64 source_hash, const LoadOptions &options,
+                 DecodedModel &out_model) {
+  out_model.vertex_format = options.vertex_format;
+  out_model.flattened = options.flatten;
+  out_model.source_hash = source_hash;
+
+  // temporaries of this decode, freed together at the end
+  utils::Arena scratch(decode_arena_block_size);
+
+  // first vertex of every entry in the mesh table
+  utils::ArenaArray<usize> mesh_first_vertex(scratch);
+
+  if (options.flatten) {
+    decode_flattened(path, data, scratch, out_model, mesh_first_vertex);
+  } else {
+    decode_meshes(path, data, scratch, out_model, mesh_first_vertex);
+  }
+
+  // each mesh is quantized against its own bounds, which the shader gets back per draw
+  if (out_model.vertex_format == comps::MeshBuffer::VertexFormat::QUANTIZED) {
+    out_model.quantized_vertices.resize(out_model.vertices.size());
+
+    for (usize i_mesh = 0; i_mesh < out_model.meshes.size(); i_mesh++) {
+      const usize first_vertex = mesh_first_vertex[i_mesh];
+      const usize end_vertex =
+          i_mesh + 1 < out_model.meshes.size() ? mesh_first_vertex[i_mesh + 1] : out_model.vertices.size();
+
+      geometry::quantize_vertices(&out_model.vertices[first_vertex], end_vertex - first_vertex,
+                                  out_model.meshes[i_mesh].bounds, &out_model.quantized_vertices[first_vertex]);
+    }
+  }
+
+  scratch.release();
+
+  // every index of a small meshbuffer fits in 16 bits
+  if (out_model.vertices.size() <= std::numeric_limits<u16>::max() + 1ull) {
+    out_model.index_format = comps::MeshBuffer::IndexFormat::U16;
+    out_model.narrow_indices.resize(out_model.indices.size());
+
+    geometry::narrow_indices(out_model.indices.data(), out_model.indices.size(), out_model.narrow_indices.data());
+  } else {
+    out_model.index_format = comps::MeshBuffer::IndexFormat::U32;
+  }
+
+  // a failed cook only costs the next launch another gltf parse
+  if (write_cooked(path, out_model.view())) {
+    LOG_INFO("cooked %s", path)
+  }
+}
+
+// word at a time, it only has to tell files apart
+static u64 hash_content(const u8 *data, const usize size) {
+  u64 hash = 0x9e3779b97f4a7c15ull ^ size;
+  usize i = 0;
+
+  for (; i + sizeof(u64) <= size; i += sizeof(u64)) {
+    u64 word;
+    memcpy(&word, data + i, sizeof(word));
+
+    hash = (hash ^ word) * 0xff51afd7ed558ccdull;
+    hash ^= hash >> 32;
+  }
+
+  for (; i < size; i++) {
+    hash = (hash ^ data[i]) * 0x100000001b3ull;
+  }
+
+  return hash ^ (hash >> 29);
+}
+
+// registry
+
+enum class LoadState : u8 {
+  // nothing resident or in flight, new loads start here and evicted ones go back here
+  UNLOADED,
+  FETCHING,
+  DECODING,
+  UPLOADING,
+  RESIDENT,
+  FAILED,
+};
+
+constexpr usize load_key_size = cooked_path_size + 32;
+
+// one per path and import options for the whole run, made by Owner::construct
+struct Load {
+  c8 key[load_key_size] = {};
+  c8 path[cooked_path_size] = {};
+  LoadOptions options = {};
+
+  // set by the worker after decoding and read by the main thread
+  std::atomic<LoadState> state = LoadState::UNLOADED;
+
+  // the cooked file instead of the gltf source is fetched
+  bool cooked = false;
 
-  prefab->meshbuffer = meshbuffer;
+  u8 *file_data = nullptr;
+  usize file_size = 0;
 
-  for (cgltf_size i_node = 0; i_node < data->scene->nodes_count; i_node++) {
-    prefab->nodes.emplace_back(parse_node(data->scene->nodes[i_node], mesh_map));
+  // of the gltf source, read from the header of a cooked file. set before decoding
+  u64 content_hash = 0;
+
+  // a load of the same content and options whose prefab this one shares, null if it has its own
+  Load *owner = nullptr;
+
+  // handles and instances holding the prefab, counted on the owner
+  u32 references = 0;
+
+  // use_clock at the last release, the least recently used prefab is evicted first
+  u64 last_used = 0;
+
+  // gpu buffer size while resident
+  usize resident_bytes = 0;
+
+  // decode output, views into either file_data, a mapped file or decoded
+  CookedModel model = {};
+  DecodedModel decoded = {};
+
+  utils::Owner<assets::Prefab> prefab;
+
+  void release_staging() {
+    utils::aligned_free_16(file_data);
+    file_data = nullptr;
+    file_size = 0;
+
+    decoded.release();
+    model = {};
+  }
+
+  void release_prefab() {
+    if (prefab.get() != nullptr) {
+      prefab->release();
+      prefab.release();
+    }
+  }
+};
+
+utils::DSArray<utils::Owner<Load>> loads;
+
+// key to index in loads, the keys live in the loads
+utils::DSStringMap<u32> load_ids;
+
+usize cache_budget = default_cache_budget;
+usize resident_bytes = 0;
+u64 use_clock = 0;
+
+flecs::system system_update;
+flecs::observer observer_instance_remove;
+
+static Load &resolve(const PrefabHandle handle) {
+  Load &load = *loads[handle.id];
+
+  return load.owner != nullptr ? *load.owner : load;
+}
+
+// finds the load for path and options or adds an unloaded one, a path too long to key fails right away
+static PrefabHandle find_or_add(const c8 *path, const LoadOptions &options) {
+  c8 key[load_key_size];
+
+  const i32 key_length = snprintf(key, sizeof(key), "%s|%u|%u", path, static_cast<u32>(options.vertex_format),
+                                  options.flatten ? 1u : 0u);
+
+  const bool keyed = key_length >= 0 && key_length < static_cast<i32>(sizeof(key)) &&
+                     strlen(path) < cooked_path_size;
+
+  if (keyed) {
+    const utils::DSStringMap<u32>::Item *item = load_ids.get_or_null(key);
+
+    if (item != nullptr) {
+      return {.id = item->value};
+    }
+  }
+
+  const PrefabHandle handle = {.id = static_cast<u32>(loads.size())};
+
+  utils::Owner<Load> owner = utils::Owner<Load>::construct();
+  Load &load = *owner;
+
+  loads.emplace_back(std::move(owner));
+
+  load.options = options;
+
+  if (!keyed) {
+    LOG_ERROR("asset path too long: %s", path)
+    load.state = LoadState::FAILED;
+    return handle;
+  }
+
+  memcpy(load.key, key, sizeof(key));
+  memcpy(load.path, path, strlen(path) + 1);
+
+  u32 id = handle.id;
+  load_ids.put(load.key, std::move(id));
+
+  return handle;
+}
+
+// unreferenced prefabs are dropped least recently used first until the resident size fits the budget
+static void evict_unused() {
+  while (resident_bytes > cache_budget) {
+    Load *oldest = nullptr;
+
+    for (usize i_load = 0; i_load < loads.size(); i_load++) {
+      Load &load = *loads[i_load];
+
+      if (load.owner == nullptr && load.state == LoadState::RESIDENT && load.references == 0 &&
+          (oldest == nullptr || load.last_used < oldest->last_used)) {
+        oldest = &load;
+      }
+    }
+
+    if (oldest == nullptr) {
+      return;
+    }
+
+    LOG_INFO("evicted %s, %zu bytes", oldest->path, oldest->resident_bytes)
+
+    resident_bytes -= oldest->resident_bytes;
+    oldest->resident_bytes = 0;
+    oldest->release_prefab();
+    oldest->state = LoadState::UNLOADED;
+  }
+}
+
+// a cooked file carries the hash of its source, so both hash the same
+static u64 get_source_hash(const Load &load, const u8 *data, const usize size) {
+  u64 hash;
+
+  if (load.cooked && read_cooked_source_hash(data, size, hash)) {
+    return hash;
+  }
+
+  return hash_content(data, size);
+}
+
+// thread safe
+static void decode_source(Load &load, const u8 *data, const usize size) {
+  cgltf_options options = {};
+  cgltf_data *gltf_data = NULL;
+
+  // glb buffers point into data, external buffers are read here
+  if (cgltf_parse(&options, data, size, &gltf_data) != cgltf_result_success ||
+      cgltf_load_buffers(&options, gltf_data, load.path) != cgltf_result_success) {
+    LOG_ERROR("can't parse gltf %s", load.path)
+
+    cgltf_free(gltf_data);
+    load.state = LoadState::FAILED;
+    return;
+  }
+
+  decode_gltf(load.path, gltf_data, load.content_hash, load.options, load.decoded);
+  cgltf_free(gltf_data);
+
+  load.model = load.decoded.view();
+  load.state = LoadState::UPLOADING;
+}
+
+// parses a cooked file or decodes a gltf file, thread safe. a cooked file that doesn't parse is recooked from its
+// source instead of failing the load
+static void decode(Load &load, const u8 *data, const usize size) {
+  if (!load.cooked) {
+    decode_source(load, data, size);
+    return;
+  }
+
+  if (parse_cooked(data, size, load.model)) {
+    load.state = LoadState::UPLOADING;
+    return;
+  }
+
+  LOG_INFO("recooking %s", load.path)
+
+  load.cooked = false;
+  load.model = {};
+
+  utils::MappedFile source;
+
+  if (!source.open(load.path)) {
+    load.state = LoadState::FAILED;
+    return;
+  }
+
+  load.content_hash = hash_content(source.data, source.size);
+  decode_source(load, source.data, source.size);
+
+  source.close();
+}
+
+// main thread, the same source under another path or handle shares the prefab that is already resident. true if
+// load is resident that way
+static bool share_resident(Load &load) {
+  for (usize i_load = 0; i_load < loads.size(); i_load++) {
+    Load &original = *loads[i_load];
+
+    if (&original == &load || original.owner != nullptr || original.state != LoadState::RESIDENT ||
+        original.content_hash != load.content_hash || original.options.vertex_format != load.options.vertex_format ||
+        original.options.flatten != load.options.flatten) {
+      continue;
+    }
+
+    LOG_INFO("%s shares the prefab of %s", load.path, original.path)
+
+    load.owner = &original;
+    original.references += load.references;
+    load.references = 0;
+
+    load.release_staging();
+    load.state = LoadState::RESIDENT;
+
+    return true;
+  }
+
+  return false;
+}
+
+// main thread, returns the uploaded size
+static usize upload(Load &load) {
+  // another load of the same source may have finished while this one was decoding
+  if (share_resident(load)) {
+    return 0;
+  }
+
+  load.prefab = make_prefab(load.model);
+
+  load.resident_bytes = load.model.vertex_count * comps::MeshBuffer::get_vertex_size(load.model.vertex_format) +
+                        load.model.index_count * comps::MeshBuffer::get_index_size(load.model.index_format);
+  resident_bytes += load.resident_bytes;
+
+  load.release_staging();
+  load.state = LoadState::RESIDENT;
+
+  return load.resident_bytes;
+}
+
+static void decode_job(void *user_data) {
+  const utils::MemoryTagScope tag_scope(utils::MemoryTag::ASSETS);
+
+  Load &load = *static_cast<Load *>(user_data);
+
+  decode(load, load.file_data, load.file_size);
+}
+
+static void fetch_callback(const sfetch_response_t *response) {
+  Load &load = **static_cast<Load **>(response->user_data);
+
+  if (response->fetched) {
+    // a duplicate of a resident prefab skips the decode
+    load.content_hash = get_source_hash(load, load.file_data, load.file_size);
+
+    if (share_resident(load)) {
+      return;
+    }
+
+    load.state = LoadState::DECODING;
+    jobs::push(decode_job, &load);
+  } else if (response->failed) {
+    LOG_ERROR("can't fetch %s, error %d", response->path, static_cast<i32>(response->error_code))
+    load.state = LoadState::FAILED;
+  }
+}
+
+static void start_fetch(Load &load) {
+  load.state = LoadState::FETCHING;
+  load.cooked = is_cooked_current(load.path, load.options.vertex_format, load.options.flatten);
+
+  c8 cooked_path[cooked_path_size];
+  const c8 *fetch_path =
+      load.cooked && make_cooked_path(load.path, load.options.vertex_format, load.options.flatten, cooked_path)
+          ? cooked_path
+          : load.path;
+
+  // sokol_fetch needs a buffer that fits the whole file up front
+  utils::FileInfo info;
+
+  if (!utils::get_file_info(fetch_path, info) || info.size == 0) {
+    LOG_ERROR("can't open %s", fetch_path)
+    load.state = LoadState::FAILED;
+    return;
+  }
+
+  load.file_size = static_cast<usize>(info.size);
+  load.file_data = static_cast<u8 *>(utils::aligned_alloc_16(load.file_size));
+
+  Load *load_pointer = &load;
+
+  sfetch_send(sfetch_request_t{
+      .path = fetch_path,
+      .callback = fetch_callback,
+      .buffer = {.ptr = load.file_data, .size = load.file_size},
+      .user_data = {.ptr = &load_pointer, .size = sizeof(load_pointer)},
+  });
+}
+
+static void update() {
+  const utils::MemoryTagScope tag_scope(utils::MemoryTag::ASSETS);
+
+  sfetch_dowork();
+
+  // upload decoded models in request order until the budget is spent, at least one per frame
+  usize uploaded_bytes = 0;
+
+  for (usize i_load = 0; i_load < loads.size() && uploaded_bytes < upload_budget; i_load++) {
+    Load &load = *loads[i_load];
+
+    if (load.state == LoadState::UPLOADING) {
+      uploaded_bytes += upload(load);
+    }
+  }
+
+  evict_unused();
+
+  // fill in the entities that were instantiated while their prefab was pending
+
+  utils::ArenaArray<flecs::entity> ready(utils::get_frame_arena());
+
+  world::main.each([&](flecs::entity entity, const comps::PendingPrefab &pending) {
+    const LoadState state = resolve({.id = pending.prefab}).state;
+
+    if (state == LoadState::RESIDENT || state == LoadState::FAILED) {
+      ready.emplace_back(flecs::entity(entity));
+    }
+  });
+
+  for (usize i_entity = 0; i_entity < ready.size(); i_entity++) {
+    flecs::entity entity = ready[i_entity];
+    const Load &load = resolve({.id = entity.get<comps::PendingPrefab>()->prefab});
+
+    if (load.state == LoadState::RESIDENT) {
+      world::main.instantiate_into(entity, utils::NonOwner<assets::Prefab>(load.prefab));
+    }
+
+    entity.remove<comps::PendingPrefab>();
   }
 
-  mesh_map.release();
-  cgltf_free(data);
+  ready.release();
+}
+
+void init() {
+  sfetch_setup(sfetch_desc_t{
+      .max_requests = 64,
+      .num_channels = 1,
+      .num_lanes = 4,
+      .logger = {.func = slog_func},
+  });
+
+  jobs::init(0);
+
+  // creates entities, so it runs outside of readonly mode
+  system_update = world::main.system("assets_update").kind(flecs::OnLoad).no_readonly().iter([](flecs::iter &) {
+    update();
+  });
 
-  out_prefab = utils::NonOwner<assets::Prefab>(prefab);
+  observer_instance_remove = world::main.observer<const comps::PrefabInstance>()
+                                 .event(flecs::OnRemove)
+                                 .each([](const comps::PrefabInstance &instance) {
+                                   release_model({.id = instance.prefab});
+                                 });
+}
+
+utils::Result load_model(const c8 *path, PrefabHandle &out_handle, const LoadOptions &options) {
+  const utils::MemoryTagScope tag_scope(utils::MemoryTag::ASSETS);
+
+  LOG_ASSERT(!world::main.is_readonly());
+
+  out_handle = find_or_add(path, options);
+
+  Load &load = resolve(out_handle);
+
+  load.references++;
 
-  prefabs.emplace_back(std::move(prefab));
+  if (load.state == LoadState::UNLOADED) {
+    load.cooked = is_cooked_current(load.path, load.options.vertex_format, load.options.flatten);
+
+    c8 cooked_path[cooked_path_size];
+    const c8 *file_path =
+        load.cooked && make_cooked_path(load.path, load.options.vertex_format, load.options.flatten, cooked_path)
+            ? cooked_path
+            : load.path;
+
+    // a cooked mapping goes straight into the gpu buffers
+    utils::MappedFile file;
+
+    if (!file.open(file_path)) {
+      load.state = LoadState::FAILED;
+    } else {
+      load.content_hash = get_source_hash(load, file.data, file.size);
+
+      if (!share_resident(load)) {
+        decode(load, file.data, file.size);
+      }
+
+      if (load.state == LoadState::UPLOADING) {
+        upload(load);
+        evict_unused();
+      }
+
+      file.close();
+    }
+  }
+
+  // an async load of the same model is already in flight. the fetch only advances in update and the decode runs on
+  // a worker, so the thread is given up between polls
+  while (load.state != LoadState::RESIDENT && load.state != LoadState::FAILED) {
+    update();
+
+    if (load.state != LoadState::RESIDENT && load.state != LoadState::FAILED) {
+      std::this_thread::yield();
+    }
+  }
+
+  if (load.state == LoadState::FAILED) {
+    return utils::Result::error("can't load model");
+  }
 
   return utils::Result::ok();
 }
 
+PrefabHandle load_model_async(const c8 *path, const LoadOptions &options) {
+  const utils::MemoryTagScope tag_scope(utils::MemoryTag::ASSETS);
+
+  const PrefabHandle handle = find_or_add(path, options);
+
+  Load &load = resolve(handle);
+
+  load.references++;
+
+  if (load.state == LoadState::UNLOADED) {
+    start_fetch(load);
+  }
+
+  return handle;
+}
+
+void release_model(const PrefabHandle handle) {
+  Load &load = resolve(handle);
+
+  LOG_ASSERT(load.references > 0);
+
+  load.references--;
+
+  if (load.references == 0) {
+    load.last_used = ++use_clock;
+    evict_unused();
+  }
+}
+
+bool is_resident(const PrefabHandle handle) { return resolve(handle).state == LoadState::RESIDENT; }
+
+bool has_failed(const PrefabHandle handle) { return resolve(handle).state == LoadState::FAILED; }
+
+bool is_loading() {
+  for (usize i_load = 0; i_load < loads.size(); i_load++) {
+    const LoadState state = loads[i_load]->state;
+
+    if (state == LoadState::FETCHING || state == LoadState::DECODING || state == LoadState::UPLOADING) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+utils::NonOwner<assets::Prefab> get_prefab(const PrefabHandle handle) {
+  return is_resident(handle) ? utils::NonOwner<assets::Prefab>(resolve(handle).prefab)
+                             : utils::NonOwner<assets::Prefab>();
+}
+
+flecs::entity instantiate(const PrefabHandle handle) {
+  resolve(handle).references++;
+
+  flecs::entity root =
+      world::main.entity().set(comps::LocalTransform{}).set(comps::PrefabInstance{.prefab = handle.id});
+
+  if (is_resident(handle)) {
+    world::main.instantiate_into(root, utils::NonOwner<assets::Prefab>(resolve(handle).prefab));
+  } else {
+    root.set(comps::PendingPrefab{.prefab = handle.id});
+  }
+
+  return root;
+}
+
+void set_cache_budget(const usize bytes) {
+  cache_budget = bytes;
+  evict_unused();
+}
+
+usize get_resident_bytes() { return resident_bytes; }
+
 void finish() {
-  for (usize i_prefab = 0; i_prefab < prefabs.size(); i_prefab++) {
-    utils::Owner<assets::Prefab> &prefab = prefabs[i_prefab];
+  system_update.destruct();
+  observer_instance_remove.destruct();
+
+  // in flight decodes finish before the fetches and their buffers go away
+  jobs::finish();
+  sfetch_shutdown();
 
-    prefab->release();
-    prefab.release();
+  for (usize i_load = 0; i_load < loads.size(); i_load++) {
+    utils::Owner<Load> &load = loads[i_load];
+
+    load->release_staging();
+    load->release_prefab();
+    load.destroy();
   }
 
-  prefabs.release();
+  loads.release();
+  load_ids.release();
+
+  resident_bytes = 0;
 }
 
 } // namespace assets
@@ -7,7 +7,62 @@
 
 namespace assets {
 
-utils::Result load_model(const c8 *path, utils::NonOwner<assets::Prefab> &out_prefab);
+// decoded models uploaded per frame, at least one model is uploaded every frame
+constexpr usize upload_budget = 16 * 1024 * 1024;
+
+// gpu memory unreferenced prefabs may keep resident before the least recently used ones are evicted
+constexpr usize default_cache_budget = 256 * 1024 * 1024;
+
+// loads are keyed by path and options, so loading a model twice returns the same handle. identical file contents
+// under different paths share one prefab as well
+struct PrefabHandle {
+  u32 id;
+};
+
+// import time settings, part of the cooked file
+struct LoadOptions {
+  // quantized vertices are half the size, positions keep 16 bits of precision across each mesh's bounds
+  comps::MeshBuffer::VertexFormat vertex_format = comps::MeshBuffer::VertexFormat::FLOAT;
+
+  // for models whose parts never move on their own, node transforms are baked into the vertices and primitives
+  // sharing a material are merged, so an instance is one entity and one draw per material
+  bool flatten = false;
+};
+
+// starts the fetch channel and decode workers and registers the OnLoad upload system
+void init();
+
+// blocks until the model is parsed and uploaded, the handle holds a reference even if loading failed. main thread
+// outside of the pipeline only, waiting on an async load of the same model runs the asset update, which creates
+// entities
+utils::Result load_model(const c8 *path, PrefabHandle &out_handle, const LoadOptions &options = {});
+
+// returns right away, the file is read by sokol_fetch, decoded on the job workers and uploaded on the main thread.
+// the handle holds a reference
+[[nodiscard]] PrefabHandle load_model_async(const c8 *path, const LoadOptions &options = {});
+
+// drops the reference of a load_model call, unreferenced prefabs stay cached until the budget needs their memory
+void release_model(const PrefabHandle handle);
+
+[[nodiscard]] bool is_resident(const PrefabHandle handle);
+
+[[nodiscard]] bool has_failed(const PrefabHandle handle);
+
+// any async load not yet resident or failed
+[[nodiscard]] bool is_loading();
+
+// null until resident
+[[nodiscard]] utils::NonOwner<assets::Prefab> get_prefab(const PrefabHandle handle);
+
+// the root entity is created right away, the prefab's nodes are added below it once resident. the instance holds a
+// reference until its root is deleted
+[[nodiscard]] flecs::entity instantiate(const PrefabHandle handle);
+
+// evicts right away if the resident prefabs are already over the new budget
+void set_cache_budget(const usize bytes);
+
+// vertex and index buffers of every resident prefab
+[[nodiscard]] usize get_resident_bytes();
 
 void finish();
 
@@ -0,0 +1,801 @@
+#include "engine.hpp"
+#include "geometry.hpp"
+#include "spatial.hpp"
+#include "transforms.hpp"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#define CGLTF_MALLOC(size) utils::aligned_alloc_16(size)
+#define CGLTF_FREE(ptr) utils::aligned_free_16(ptr)
+#define CGLTF_IMPLEMENTATION
+#include "thirdparty/cgltf/cgltf.h"
+
+#define STB_DS_IMPLEMENTATION
+#include "thirdparty/stb/stb_ds.h"
+
+#define SOKOL_TIME_IMPL
+#include "thirdparty/sokol/sokol_time.h"
+
+// standalone micro benchmarks, run all with `lbtl-bench` or a single one with `lbtl-bench <name>`
+
+namespace bench {
+
+struct Random {
+  u64 state = 0x853c49e6748fea9bull;
+
+  u32 next() {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return static_cast<u32>(state >> 32);
+  }
+
+  f32 range(const f32 min, const f32 max) { return min + (max - min) * (next() / 4294967296.0f); }
+
+  HMM_Vec3 vec3(const f32 min, const f32 max) { return HMM_V3(range(min, max), range(min, max), range(min, max)); }
+};
+
+// spatial
+
+void spatial_tree() {
+  constexpr usize entity_counts[] = {10'000, 100'000, 1'000'000};
+  constexpr usize query_count = 1000;
+
+  for (const usize entity_count : entity_counts) {
+    Random random;
+    spatial::Tree tree;
+
+    utils::DSArray<i32> proxies;
+    utils::DSArray<HMM_Vec3> positions;
+
+    proxies.resize(entity_count);
+    positions.resize(entity_count);
+
+    const f32 world_size = cbrtf(static_cast<f32>(entity_count)) * 10.0f;
+
+    const auto make_aabb = [](const HMM_Vec3 position) {
+      return spatial::AABB{.min = position - HMM_V3(1, 1, 1), .max = position + HMM_V3(1, 1, 1)};
+    };
+
+    // build
+
+    u64 start = stm_now();
+
+    for (usize i = 0; i < entity_count; i++) {
+      positions[i] = random.vec3(0.0f, world_size);
+      proxies[i] = tree.insert(make_aabb(positions[i]), i);
+    }
+
+    const f64 build_ms = stm_ms(stm_since(start));
+
+    // update, small movements stay inside the fat boxes
+
+    start = stm_now();
+
+    usize small_reinserts = 0;
+
+    for (usize i = 0; i < entity_count; i++) {
+      positions[i] += random.vec3(-0.05f, 0.05f);
+      small_reinserts += tree.move(proxies[i], make_aabb(positions[i]));
+    }
+
+    const f64 small_update_ms = stm_ms(stm_since(start));
+
+    // update, 10% of the entities teleport
+
+    start = stm_now();
+
+    usize large_reinserts = 0;
+
+    for (usize i = 0; i < entity_count; i += 10) {
+      positions[i] = random.vec3(0.0f, world_size);
+      large_reinserts += tree.move(proxies[i], make_aabb(positions[i]));
+    }
+
+    const f64 large_update_ms = stm_ms(stm_since(start));
+
+    // frustum query from the center of the world
+
+    const HMM_Vec3 eye = HMM_V3(world_size * 0.5f, world_size * 0.5f, world_size * 0.5f);
+    const HMM_Mat4 view = HMM_LookAt_RH(eye, eye + HMM_V3(0, 0, -1), HMM_V3(0, 1, 0));
+    const culling::Frustum frustum =
+        culling::make_frustum(HMM_Perspective_RH_ZO(0.25f, 1.5f, 0.1f, world_size * 0.5f) * view);
+
+    start = stm_now();
+
+    usize frustum_hits = 0;
+
+    tree.query_frustum(frustum, [&](u64, bool) {
+      frustum_hits++;
+      return true;
+    });
+
+    const f64 frustum_ms = stm_ms(stm_since(start));
+
+    // aabb queries
+
+    start = stm_now();
+
+    usize aabb_hits = 0;
+
+    for (usize i_query = 0; i_query < query_count; i_query++) {
+      const HMM_Vec3 center = random.vec3(0.0f, world_size);
+
+      tree.query_aabb(spatial::AABB{.min = center - HMM_V3(10, 10, 10), .max = center + HMM_V3(10, 10, 10)},
+                      [&](u64) {
+                        aabb_hits++;
+                        return true;
+                      });
+    }
+
+    const f64 aabb_ms = stm_ms(stm_since(start));
+
+    // sphere queries
+
+    start = stm_now();
+
+    usize sphere_hits = 0;
+
+    for (usize i_query = 0; i_query < query_count; i_query++) {
+      tree.query_sphere(random.vec3(0.0f, world_size), 10.0f, [&](u64) {
+        sphere_hits++;
+        return true;
+      });
+    }
+
+    const f64 sphere_ms = stm_ms(stm_since(start));
+
+    // closest hit ray queries
+
+    start = stm_now();
+
+    usize ray_hits = 0;
+
+    for (usize i_query = 0; i_query < query_count; i_query++) {
+      const spatial::Ray ray = {
+          .origin = random.vec3(0.0f, world_size),
+          .direction = HMM_NormV3(random.vec3(-1.0f, 1.0f)),
+          .max_distance = 100.0f,
+      };
+
+      bool hit = false;
+
+      tree.query_ray(ray, [&](u64, const f32 distance) {
+        hit = true;
+        return distance;
+      });
+
+      ray_hits += hit;
+    }
+
+    const f64 ray_ms = stm_ms(stm_since(start));
+
+    LOG_INFO("spatial_tree %zu entities (height %d)", entity_count, tree.height())
+    LOG_INFO("  build          %10.3f ms", build_ms)
+    LOG_INFO("  small moves    %10.3f ms (%zu reinserted)", small_update_ms, small_reinserts)
+    LOG_INFO("  10%% teleports  %10.3f ms (%zu reinserted)", large_update_ms, large_reinserts)
+    LOG_INFO("  frustum        %10.3f ms (%zu hits)", frustum_ms, frustum_hits)
+    LOG_INFO("  aabb query     %10.3f us avg (%zu hits)", aabb_ms * 1000.0 / query_count, aabb_hits)
+    LOG_INFO("  sphere query   %10.3f us avg (%zu hits)", sphere_ms * 1000.0 / query_count, sphere_hits)
+    LOG_INFO("  ray query      %10.3f us avg (%zu hits)", ray_ms * 1000.0 / query_count, ray_hits)
+
+    tree.release();
+    proxies.release();
+    positions.release();
+  }
+}
+
+// transforms
+
+void transform_compose() {
+  constexpr usize transform_counts[] = {1'000, 10'000, 100'000};
+  constexpr usize repetitions = 100;
+
+  constexpr transforms::Backend backends[] = {
+      transforms::Backend::SCALAR,
+      transforms::Backend::SSE,
+      transforms::Backend::AVX,
+  };
+
+  const transforms::Backend best_backend = transforms::get_backend();
+
+  for (const usize transform_count : transform_counts) {
+    Random random;
+
+    utils::DSArray<comps::LocalTransform> locals;
+    utils::DSArray<comps::WorldMatrix> worlds;
+    utils::DSArray<HMM_Mat4> reference;
+    utils::DSArray<u32> indices;
+
+    locals.resize(transform_count);
+    worlds.resize(transform_count);
+    reference.resize(transform_count);
+    indices.resize(transform_count);
+
+    for (usize i = 0; i < transform_count; i++) {
+      locals[i] = comps::LocalTransform{
+          .translation = random.vec3(-100.0f, 100.0f),
+          .rotation = HMM_NormQ(HMM_Q(random.range(-1, 1), random.range(-1, 1), random.range(-1, 1), 1.0f)),
+      };
+      indices[i] = static_cast<u32>(i);
+    }
+
+    const HMM_Mat4 parent = HMM_Translate(HMM_V3(1, 2, 3)) * HMM_Rotate_RH(0.1f, HMM_V3(0, 1, 0));
+
+    // the per entity lambda World::update used before the batch kernel
+
+    u64 start = stm_now();
+
+    for (usize i_repetition = 0; i_repetition < repetitions; i_repetition++) {
+      for (usize i = 0; i < transform_count; i++) {
+        HMM_Mat4 &matrix = worlds[i].matrix;
+
+        matrix = HMM_QToM4(locals[i].rotation);
+        HMM_TranslateInplace(matrix, locals[i].translation);
+        matrix = parent * matrix;
+      }
+    }
+
+    const f64 lambda_ms = stm_ms(stm_since(start)) / repetitions;
+
+    for (usize i = 0; i < transform_count; i++) {
+      reference[i] = worlds[i].matrix;
+    }
+
+    LOG_INFO("transform_compose %zu transforms", transform_count)
+    LOG_INFO("  lambda     %10.3f us", lambda_ms * 1000.0)
+
+    for (const transforms::Backend backend : backends) {
+      if (backend > best_backend) {
+        continue;
+      }
+
+      start = stm_now();
+
+      for (usize i_repetition = 0; i_repetition < repetitions; i_repetition++) {
+        transforms::compose_world(backend, locals.data(), worlds.data(), indices.data(), transform_count, &parent);
+      }
+
+      const f64 backend_ms = stm_ms(stm_since(start)) / repetitions;
+
+      f32 max_error = 0.0f;
+
+      for (usize i = 0; i < transform_count; i++) {
+        for (usize i_element = 0; i_element < 16; i_element++) {
+          const f32 error = fabsf(worlds[i].matrix.Elements[i_element / 4][i_element % 4] -
+                                  reference[i].Elements[i_element / 4][i_element % 4]);
+
+          max_error = HMM_MAX(max_error, error);
+        }
+      }
+
+      LOG_INFO("  %-10s %10.3f us (%.2fx, max error %g)", transforms::get_backend_name(backend),
+               backend_ms * 1000.0, lambda_ms / backend_ms, max_error)
+    }
+
+    locals.release();
+    worlds.release();
+    reference.release();
+    indices.release();
+  }
+}
+
+// the single component layout used before LocalTransform and WorldMatrix were split
+struct PackedTransform {
+  HMM_Vec3 translation;
+  HMM_Quat rotation;
+  HMM_Mat4 world;
+  bool dirty;
+  bool moved;
+};
+
+void transform_layout() {
+  constexpr usize transform_count = 1'000'000;
+  constexpr usize repetitions = 20;
+
+  // share of the transforms a physics step moves
+  constexpr u32 moving_percent = 10;
+
+  Random random;
+
+  utils::DSArray<PackedTransform> packed;
+  utils::DSArray<comps::LocalTransform> locals;
+  utils::DSArray<comps::WorldMatrix> worlds;
+  utils::DSArray<HMM_Vec3> positions;
+
+  packed.resize(transform_count);
+  locals.resize(transform_count);
+  worlds.resize(transform_count);
+  positions.resize(transform_count);
+
+  for (usize i = 0; i < transform_count; i++) {
+    packed[i] = PackedTransform{.rotation = HMM_Q(0, 0, 0, 1), .world = HMM_M4D(1.0f)};
+    locals[i] = comps::LocalTransform{};
+    worlds[i] = comps::WorldMatrix{.matrix = HMM_M4D(1.0f)};
+    positions[i] = random.vec3(-100.0f, 100.0f);
+  }
+
+  const auto is_moving = [](const usize i) { return (i * 2654435761u) % 100 < moving_percent; };
+
+  // physics sync, writes the moving bodies back
+
+  u64 start = stm_now();
+
+  for (usize i_repetition = 0; i_repetition < repetitions; i_repetition++) {
+    for (usize i = 0; i < transform_count; i++) {
+      if (is_moving(i) && !(packed[i].translation == positions[i])) {
+        packed[i].translation = positions[i];
+        packed[i].dirty = true;
+      }
+    }
+  }
+
+  const f64 packed_sync_ms = stm_ms(stm_since(start)) / repetitions;
+
+  start = stm_now();
+
+  for (usize i_repetition = 0; i_repetition < repetitions; i_repetition++) {
+    for (usize i = 0; i < transform_count; i++) {
+      if (is_moving(i) && !(locals[i].translation == positions[i])) {
+        locals[i].translation = positions[i];
+        locals[i].dirty = true;
+      }
+    }
+  }
+
+  const f64 split_sync_ms = stm_ms(stm_since(start)) / repetitions;
+
+  // transform pass, dirty scan over everything and compose the moved ones
+
+  const auto compose_packed = [&]() {
+    for (usize i = 0; i < transform_count; i++) {
+      PackedTransform &transform = packed[i];
+
+      transform.moved = transform.dirty;
+
+      if (!transform.moved) {
+        continue;
+      }
+
+      transform.dirty = false;
+      transform.world = HMM_QToM4(transform.rotation);
+      HMM_TranslateInplace(transform.world, transform.translation);
+    }
+  };
+
+  const auto compose_split = [&]() {
+    for (usize i = 0; i < transform_count; i++) {
+      comps::LocalTransform &local = locals[i];
+
+      local.moved = local.dirty;
+
+      if (!local.moved) {
+        continue;
+      }
+
+      local.dirty = false;
+      worlds[i].matrix = HMM_QToM4(local.rotation);
+      HMM_TranslateInplace(worlds[i].matrix, local.translation);
+    }
+  };
+
+  f64 packed_compose_ms = 0.0;
+  f64 split_compose_ms = 0.0;
+
+  for (usize i_repetition = 0; i_repetition < repetitions; i_repetition++) {
+    for (usize i = 0; i < transform_count; i++) {
+      packed[i].dirty = is_moving(i);
+      locals[i].dirty = is_moving(i);
+    }
+
+    start = stm_now();
+    compose_packed();
+    packed_compose_ms += stm_ms(stm_since(start)) / repetitions;
+
+    start = stm_now();
+    compose_split();
+    split_compose_ms += stm_ms(stm_since(start)) / repetitions;
+  }
+
+  LOG_INFO("transform_layout %zu transforms, %u%% moving (%zu vs %zu + %zu bytes)", transform_count, moving_percent,
+           sizeof(PackedTransform), sizeof(comps::LocalTransform), sizeof(comps::WorldMatrix))
+  LOG_INFO("  sync     packed %10.3f ms, split %10.3f ms (%.2fx)", packed_sync_ms, split_sync_ms,
+           packed_sync_ms / split_sync_ms)
+  LOG_INFO("  compose  packed %10.3f ms, split %10.3f ms (%.2fx)", packed_compose_ms, split_compose_ms,
+           packed_compose_ms / split_compose_ms)
+
+  packed.release();
+  locals.release();
+  worlds.release();
+  positions.release();
+}
+
+// gltf import
+
+// glb with float32 attributes in separate views and u32 indices, the common exporter layout
+static void make_glb(const usize mesh_count, const usize vertex_count, const usize index_count,
+                     utils::DSArray<u8> &out_glb) {
+  const usize total_vertices = mesh_count * vertex_count;
+  const usize total_indices = mesh_count * index_count;
+
+  const usize position_offset = 0;
+  const usize normal_offset = position_offset + total_vertices * 3 * sizeof(f32);
+  const usize texcoord_offset = normal_offset + total_vertices * 3 * sizeof(f32);
+  const usize index_offset = texcoord_offset + total_vertices * 2 * sizeof(f32);
+  const usize bin_size = index_offset + total_indices * sizeof(u32);
+
+  utils::DSArray<u8> bin;
+  bin.resize(bin_size);
+
+  Random random;
+
+  f32 *positions = reinterpret_cast<f32 *>(bin.data() + position_offset);
+  f32 *normals = reinterpret_cast<f32 *>(bin.data() + normal_offset);
+  f32 *texcoords = reinterpret_cast<f32 *>(bin.data() + texcoord_offset);
+  u32 *indices = reinterpret_cast<u32 *>(bin.data() + index_offset);
+
+  for (usize i = 0; i < total_vertices; i++) {
+    const HMM_Vec3 normal = HMM_NormV3(random.vec3(-1.0f, 1.0f) + HMM_V3(0.0f, 0.0f, 1e-3f));
+
+    positions[i * 3 + 0] = random.range(-1.0f, 1.0f);
+    positions[i * 3 + 1] = random.range(-1.0f, 1.0f);
+    positions[i * 3 + 2] = random.range(-1.0f, 1.0f);
+    normals[i * 3 + 0] = normal.X;
+    normals[i * 3 + 1] = normal.Y;
+    normals[i * 3 + 2] = normal.Z;
+    texcoords[i * 2 + 0] = random.range(0.0f, 1.0f);
+    texcoords[i * 2 + 1] = random.range(0.0f, 1.0f);
+  }
+
+  for (usize i = 0; i < total_indices; i++) {
+    indices[i] = random.next() % vertex_count;
+  }
+
+  std::string json = "{\"asset\":{\"version\":\"2.0\"},\"buffers\":[{\"byteLength\":" + std::to_string(bin_size) + "}],";
+
+  c8 tmp[512];
+
+  snprintf(tmp, sizeof(tmp),
+           "\"bufferViews\":[{\"buffer\":0,\"byteOffset\":%zu,\"byteLength\":%zu},"
+           "{\"buffer\":0,\"byteOffset\":%zu,\"byteLength\":%zu},{\"buffer\":0,\"byteOffset\":%zu,\"byteLength\":%zu},"
+           "{\"buffer\":0,\"byteOffset\":%zu,\"byteLength\":%zu}],",
+           position_offset, normal_offset - position_offset, normal_offset, texcoord_offset - normal_offset,
+           texcoord_offset, index_offset - texcoord_offset, index_offset, bin_size - index_offset);
+  json += tmp;
+
+  json += "\"accessors\":[";
+
+  for (usize i_mesh = 0; i_mesh < mesh_count; i_mesh++) {
+    snprintf(tmp, sizeof(tmp),
+             "%s{\"bufferView\":0,\"byteOffset\":%zu,\"componentType\":5126,\"count\":%zu,\"type\":\"VEC3\","
+             "\"min\":[-1,-1,-1],\"max\":[1,1,1]},"
+             "{\"bufferView\":1,\"byteOffset\":%zu,\"componentType\":5126,\"count\":%zu,\"type\":\"VEC3\"},"
+             "{\"bufferView\":2,\"byteOffset\":%zu,\"componentType\":5126,\"count\":%zu,\"type\":\"VEC2\"},"
+             "{\"bufferView\":3,\"byteOffset\":%zu,\"componentType\":5125,\"count\":%zu,\"type\":\"SCALAR\"}",
+             i_mesh > 0 ? "," : "", i_mesh * vertex_count * 3 * sizeof(f32), vertex_count,
+             i_mesh * vertex_count * 3 * sizeof(f32), vertex_count, i_mesh * vertex_count * 2 * sizeof(f32),
+             vertex_count, i_mesh * index_count * sizeof(u32), index_count);
+    json += tmp;
+  }
+
+  json += "],\"meshes\":[";
+
+  for (usize i_mesh = 0; i_mesh < mesh_count; i_mesh++) {
+    const usize first = i_mesh * 4;
+
+    snprintf(tmp, sizeof(tmp),
+             "%s{\"primitives\":[{\"attributes\":{\"POSITION\":%zu,\"NORMAL\":%zu,\"TEXCOORD_0\":%zu},\"indices\":%zu}]}",
+             i_mesh > 0 ? "," : "", first, first + 1, first + 2, first + 3);
+    json += tmp;
+  }
+
+  json += "]}";
+
+  while (json.size() % 4 != 0) {
+    json += ' ';
+  }
+
+  const u32 json_size = static_cast<u32>(json.size());
+  const u32 glb_size = static_cast<u32>(12 + 8 + json_size + 8 + bin_size);
+
+  const u32 header[] = {0x46546c67, 2, glb_size};
+  const u32 json_chunk[] = {json_size, 0x4e4f534a};
+  const u32 bin_chunk[] = {static_cast<u32>(bin_size), 0x004e4942};
+
+  out_glb.resize(glb_size);
+
+  u8 *out = out_glb.data();
+
+  memcpy(out, header, sizeof(header));
+  out += sizeof(header);
+  memcpy(out, json_chunk, sizeof(json_chunk));
+  out += sizeof(json_chunk);
+  memcpy(out, json.data(), json_size);
+  out += json_size;
+  memcpy(out, bin_chunk, sizeof(bin_chunk));
+  out += sizeof(bin_chunk);
+  memcpy(out, bin.data(), bin_size);
+
+  bin.release();
+}
+
+void gltf_import() {
+  // meshes of u16 size appended into one vertex array, like assets::parse_prim does
+  constexpr usize mesh_count = 48;
+  constexpr usize vertex_count = 65'535;
+  constexpr usize index_count = vertex_count * 3;
+  constexpr usize repetitions = 5;
+
+  utils::DSArray<u8> glb;
+  make_glb(mesh_count, vertex_count, index_count, glb);
+
+  cgltf_options options = {};
+  cgltf_data *data = nullptr;
+
+  u64 start = stm_now();
+
+  LOG_ASSERT(cgltf_parse(&options, glb.data(), glb.size(), &data) == cgltf_result_success);
+  LOG_ASSERT(cgltf_load_buffers(&options, data, nullptr) == cgltf_result_success);
+
+  const f64 parse_ms = stm_ms(stm_since(start));
+
+  utils::DSArray<comps::MeshBuffer::Vertex> generic_vertices;
+  utils::DSArray<u32> generic_indices;
+  utils::DSArray<comps::MeshBuffer::Vertex> bulk_vertices;
+  utils::DSArray<u32> bulk_indices;
+
+  generic_vertices.resize(mesh_count * vertex_count);
+  generic_indices.resize(mesh_count * index_count);
+  bulk_vertices.resize(mesh_count * vertex_count);
+  bulk_indices.resize(mesh_count * index_count);
+
+  const auto decode = [&](const bool bulk, comps::MeshBuffer::Vertex *vertices,
+                          u32 *indices) {
+    for (cgltf_size i_mesh = 0; i_mesh < data->meshes_count; i_mesh++) {
+      const cgltf_primitive &prim = data->meshes[i_mesh].primitives[0];
+      const u32 base_vertex = static_cast<u32>(i_mesh * vertex_count);
+
+      const geometry::VertexAccessors accessors = {
+          .position = prim.attributes[0].data,
+          .normal = prim.attributes[1].data,
+          .texcoord = prim.attributes[2].data,
+      };
+
+      HMM_Vec3 bounds_min;
+      HMM_Vec3 bounds_max;
+
+      if (bulk) {
+        LOG_ASSERT(geometry::is_bulk_readable(accessors));
+
+        geometry::unpack_vertices_bulk(accessors, vertices + i_mesh * vertex_count, bounds_min, bounds_max);
+        LOG_ASSERT(geometry::unpack_indices_bulk(prim.indices, base_vertex, indices + i_mesh * index_count));
+      } else {
+        geometry::unpack_vertices_generic(accessors, vertices + i_mesh * vertex_count, bounds_min, bounds_max);
+        geometry::unpack_indices_generic(prim.indices, base_vertex, indices + i_mesh * index_count);
+      }
+    }
+  };
+
+  f64 generic_ms = 0.0;
+  f64 bulk_ms = 0.0;
+
+  for (usize i_repetition = 0; i_repetition < repetitions; i_repetition++) {
+    start = stm_now();
+    decode(false, generic_vertices.data(), generic_indices.data());
+    generic_ms += stm_ms(stm_since(start)) / repetitions;
+
+    start = stm_now();
+    decode(true, bulk_vertices.data(), bulk_indices.data());
+    bulk_ms += stm_ms(stm_since(start)) / repetitions;
+  }
+
+  LOG_ASSERT(memcmp(generic_vertices.data(), bulk_vertices.data(),
+                    generic_vertices.size() * sizeof(comps::MeshBuffer::Vertex)) == 0);
+  LOG_ASSERT(memcmp(generic_indices.data(), bulk_indices.data(),
+                    generic_indices.size() * sizeof(u32)) == 0);
+
+  const f64 vertex_millions = static_cast<f64>(mesh_count * vertex_count) / 1'000'000.0;
+
+  LOG_INFO("gltf_import %zu meshes, %.2fM vertices, %.2fM indices (%.1f MiB glb, parse %.3f ms)", mesh_count,
+           vertex_millions, static_cast<f64>(mesh_count * index_count) / 1'000'000.0,
+           static_cast<f64>(glb.size()) / (1024.0 * 1024.0), parse_ms)
+  LOG_INFO("  decode  generic %10.3f ms, bulk %10.3f ms (%.2fx, %.0f Mvertices/s)", generic_ms, bulk_ms,
+           generic_ms / bulk_ms, vertex_millions / (bulk_ms / 1000.0))
+
+  cgltf_free(data);
+
+  glb.release();
+  generic_vertices.release();
+  generic_indices.release();
+  bulk_vertices.release();
+  bulk_indices.release();
+}
+
+// allocator
+
+struct Allocator {
+  const c8 *name;
+  void *(*alloc)(usize);
+  void (*free)(void *);
+};
+
+constexpr Allocator allocators[] = {
+    {"engine", [](const usize size) { return utils::aligned_alloc_16(size); }, utils::aligned_free_16},
+    {"malloc", malloc, free},
+};
+
+// mostly container and node sized blocks, every 64th one a larger buffer
+static usize random_size(Random &random) {
+  const u32 value = random.next();
+
+  return value % 64 == 0 ? 1024 + value % (64 * 1024) : 8 + value % 512;
+}
+
+// frees a random live block and allocates a new one in its place
+static void churn(const Allocator &allocator, Random &random, void **live, const usize live_count,
+                  const usize operation_count) {
+  for (usize i = 0; i < operation_count; i++) {
+    void *&block = live[random.next() % live_count];
+
+    allocator.free(block);
+
+    const usize size = random_size(random);
+    block = allocator.alloc(size);
+
+    static_cast<u8 *>(block)[size - 1] = 1;
+  }
+}
+
+void allocator() {
+  constexpr usize live_count = 4096;
+  constexpr usize operation_count = 2'000'000;
+  constexpr usize thread_count = 4;
+  constexpr usize batch_size = 100'000;
+  constexpr usize rounds = 10;
+
+  LOG_INFO("allocator %zu live blocks, %zu threads", live_count, thread_count)
+
+  f64 engine_ns[3] = {};
+
+  for (const Allocator &allocator : allocators) {
+    // one thread
+
+    Random random;
+    void *live[live_count] = {};
+
+    u64 start = stm_now();
+
+    churn(allocator, random, live, live_count, operation_count);
+
+    const f64 single_ns = stm_ns(stm_since(start)) / operation_count;
+
+    for (void *block : live) {
+      allocator.free(block);
+    }
+
+    // every thread on its own blocks
+
+    std::thread threads[thread_count];
+
+    start = stm_now();
+
+    for (usize i_thread = 0; i_thread < thread_count; i_thread++) {
+      threads[i_thread] = std::thread([&allocator, i_thread] {
+        Random thread_random = {.state = 0x9e3779b97f4a7c15ull * (i_thread + 1)};
+        void *thread_live[live_count] = {};
+
+        churn(allocator, thread_random, thread_live, live_count, operation_count);
+
+        for (void *block : thread_live) {
+          allocator.free(block);
+        }
+      });
+    }
+
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+
+    const f64 parallel_ns = stm_ns(stm_since(start)) / (operation_count * thread_count);
+
+    // every thread frees the batch its neighbour allocated the round before, like job results released on the main
+    // thread. rounds alternate between two sets of batches
+
+    utils::DSArray<void *> batches[2][thread_count];
+
+    for (utils::DSArray<void *> &batch : batches[0]) {
+      batch.resize(batch_size);
+    }
+
+    for (utils::DSArray<void *> &batch : batches[1]) {
+      batch.resize(batch_size);
+    }
+
+    start = stm_now();
+
+    for (usize i_round = 0; i_round < rounds; i_round++) {
+      for (usize i_thread = 0; i_thread < thread_count; i_thread++) {
+        threads[i_thread] = std::thread([&allocator, &batches, i_thread, i_round] {
+          Random thread_random = {.state = 0x9e3779b97f4a7c15ull * (i_thread + 1) + i_round};
+          utils::DSArray<void *> &own = batches[i_round % 2][i_thread];
+          utils::DSArray<void *> &other = batches[(i_round + 1) % 2][(i_thread + 1) % thread_count];
+
+          if (i_round > 0) {
+            for (usize i = 0; i < batch_size; i++) {
+              allocator.free(other[i]);
+            }
+          }
+
+          for (usize i = 0; i < batch_size; i++) {
+            own[i] = allocator.alloc(random_size(thread_random));
+          }
+        });
+      }
+
+      for (std::thread &thread : threads) {
+        thread.join();
+      }
+    }
+
+    const f64 remote_ns = stm_ns(stm_since(start)) / (batch_size * thread_count * rounds);
+
+    // the last round's batches were never freed by a neighbour
+    for (utils::DSArray<void *> &batch : batches[(rounds - 1) % 2]) {
+      for (usize i = 0; i < batch_size; i++) {
+        allocator.free(batch[i]);
+      }
+    }
+
+    for (utils::DSArray<void *> &batch : batches[0]) {
+      batch.release();
+    }
+
+    for (utils::DSArray<void *> &batch : batches[1]) {
+      batch.release();
+    }
+
+    if (&allocator == &allocators[0]) {
+      engine_ns[0] = single_ns;
+      engine_ns[1] = parallel_ns;
+      engine_ns[2] = remote_ns;
+    }
+
+    LOG_INFO("  %-8s single %7.2f ns (%.2fx), threads %7.2f ns (%.2fx), cross thread %7.2f ns (%.2fx)",
+             allocator.name, single_ns, single_ns / engine_ns[0], parallel_ns, parallel_ns / engine_ns[1], remote_ns,
+             remote_ns / engine_ns[2])
+  }
+}
+
+struct Benchmark {
+  const c8 *name;
+  void (*run)();
+};
+
+constexpr Benchmark benchmarks[] = {
+    {"spatial_tree", spatial_tree},
+    {"transform_compose", transform_compose},
+    {"transform_layout", transform_layout},
+    {"gltf_import", gltf_import},
+    {"allocator", allocator},
+};
+
+} // namespace bench
+
+int main(int argc, char *argv[]) {
+  stm_setup();
+
+  const c8 *filter = argc > 1 ? argv[1] : nullptr;
+
+  for (const bench::Benchmark &benchmark : bench::benchmarks) {
+    if (filter == nullptr || strcmp(filter, benchmark.name) == 0) {
+      benchmark.run();
+    }
+  }
+
+  utils::assert_no_leaks();
+
+  return 0;
+}
@@ -11,11 +11,23 @@ class RigidBody;
 
 namespace comps {
 
-struct Transform {
+// hot half of a transform, read and written by gameplay, physics and the dirty scan in World::update
+struct LocalTransform {
   HMM_Vec3 translation = HMM_V3(0.0f, 0.0f, 0.0f);
   HMM_Quat rotation = HMM_Q(0.0f, 0.0f, 0.0f, 1.0f);
 
-  HMM_Mat4 world;
+  // set after changing translation or rotation, the world matrix is only recomputed for dirty transforms and their
+  // children
+  bool dirty = true;
+
+  // world matrix changed during the last World::update
+  bool moved = false;
+};
+
+// cold half of a transform, only touched for moved entities and by rendering,
+// added automatically to every entity with a LocalTransform
+struct WorldMatrix {
+  HMM_Mat4 matrix;
 };
 
 struct RigidBody {
@@ -23,6 +35,12 @@ struct RigidBody {
 
   float linear_damping = 0.0f;
   float angular_damping = 0.0f;
+
+  // body state after the last two fixed ticks, the LocalTransform is interpolated between them every frame
+  HMM_Vec3 _previous_translation;
+  HMM_Quat _previous_rotation;
+  HMM_Vec3 _current_translation;
+  HMM_Quat _current_rotation;
 };
 
 struct Camera {
@@ -43,19 +61,87 @@ struct MeshBuffer {
     float uv[2];
   };
 
-  using IndexType = u16;
+  // position in snorm16 relative to the mesh bounds (w unused), octahedral snorm16 normal and half float uv
+  struct QuantizedVertex {
+    i16 position[4];
+    i16 normal[2];
+    u16 uv[2];
+  };
+
+  enum class VertexFormat : u8 {
+    FLOAT,
+    QUANTIZED,
+  };
+
+  // u16 unless the meshbuffer holds more vertices than it can address
+  enum class IndexFormat : u8 {
+    U16,
+    U32,
+  };
+
+  [[nodiscard]] static constexpr usize get_vertex_size(const VertexFormat format) {
+    return format == VertexFormat::QUANTIZED ? sizeof(QuantizedVertex) : sizeof(Vertex);
+  }
 
+  [[nodiscard]] static constexpr usize get_index_size(const IndexFormat format) {
+    return format == IndexFormat::U32 ? sizeof(u32) : sizeof(u16);
+  }
+
+  VertexFormat vertex_format;
+  IndexFormat index_format;
   sg_pipeline pipeline;
   sg_bindings bindings;
 };
 
+struct Bounds {
+  HMM_Vec3 center;
+  HMM_Vec3 extents;
+  f32 radius;
+};
+
+// simplified version of a mesh, drawn from the same vertices
+struct MeshLod {
+  u32 base_element;
+  u32 index_count;
+
+  // largest distance to the full mesh in model space, scaled to pixels when picking a lod
+  f32 error;
+};
+
 struct Mesh {
-  MeshBuffer::IndexType base_vertex;
-  MeshBuffer::IndexType index_count;
+  static constexpr u32 max_lods = 3;
+
+  // first index in the meshbuffer, the indices already include the mesh's vertex offset
+  u32 base_element;
+  u32 index_count;
+
+  Bounds bounds;
+
+  // from fine to coarse, all of them follow the full mesh in the index buffer
+  u32 lod_count;
+  MeshLod lods[max_lods];
+};
+
+// leaf in the world's spatial index, added automatically to every entity with a Mesh
+struct SpatialProxy {
+  i32 id = -1;
+};
+
+// root of an instance whose prefab is still loading, see assets::instantiate
+struct PendingPrefab {
+  u32 prefab;
+};
+
+// root of every instance made by assets::instantiate, removing it releases the instance's reference on the prefab
+struct PrefabInstance {
+  u32 prefab;
 };
 
 struct Player {
   HMM_Vec2 head_angles;
+
+  // entity under the crosshair, 0 if none
+  u64 target;
 };
 
 } // namespace comps
@@ -0,0 +1,294 @@
+#include "cooked.hpp"
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace assets {
+
+static_assert(std::is_trivially_copyable_v<comps::MeshBuffer::Vertex>);
+static_assert(std::is_trivially_copyable_v<comps::MeshBuffer::QuantizedVertex>);
+static_assert(std::is_trivially_copyable_v<comps::Mesh>);
+static_assert(std::is_trivially_copyable_v<CookedNode>);
+
+constexpr u64 cooked_alignment = 16;
+
+static u64 align_offset(const u64 offset) { return (offset + cooked_alignment - 1) & ~(cooked_alignment - 1); }
+
+bool make_cooked_path(const c8 *source_path, const comps::MeshBuffer::VertexFormat vertex_format,
+                      const bool flattened, c8 (&out_path)[cooked_path_size]) {
+  const c8 *format_name = vertex_format == comps::MeshBuffer::VertexFormat::QUANTIZED ? "quantized" : "float";
+
+  const i32 length = snprintf(out_path, cooked_path_size, "%s.%s%s%s", source_path, format_name,
+                              flattened ? ".flat" : "", cooked_extension);
+
+  return length > 0 && static_cast<usize>(length) < cooked_path_size;
+}
+
+static bool read_header(const c8 *cooked_path, CookedHeader &out_header) {
+  FILE *file = fopen(cooked_path, "rb");
+
+  if (file == nullptr) {
+    return false;
+  }
+
+  const bool success = fread(&out_header, sizeof(CookedHeader), 1, file) == 1;
+
+  fclose(file);
+
+  return success;
+}
+
+static bool is_header_current(const CookedHeader &header, const utils::FileInfo &source_info,
+                              const comps::MeshBuffer::VertexFormat vertex_format, const bool flattened) {
+  return header.magic == cooked_magic && header.version == cooked_version &&
+         header.source_size == source_info.size && header.source_modified_time == source_info.modified_time &&
+         header.vertex_format == static_cast<u32>(vertex_format) && header.flattened == (flattened ? 1u : 0u) &&
+         header.vertex_size == comps::MeshBuffer::get_vertex_size(vertex_format) &&
+         header.index_format <= static_cast<u32>(comps::MeshBuffer::IndexFormat::U32) &&
+         header.index_size ==
+             comps::MeshBuffer::get_index_size(static_cast<comps::MeshBuffer::IndexFormat>(header.index_format)) &&
+         header.mesh_size == sizeof(comps::Mesh) && header.node_size == sizeof(CookedNode);
+}
+
+bool is_cooked_current(const c8 *source_path, const comps::MeshBuffer::VertexFormat vertex_format,
+                       const bool flattened) {
+  c8 cooked_path[cooked_path_size];
+
+  if (!make_cooked_path(source_path, vertex_format, flattened, cooked_path)) {
+    return false;
+  }
+
+  utils::FileInfo source_info;
+  CookedHeader header;
+
+  if (!utils::get_file_info(source_path, source_info) || !read_header(cooked_path, header)) {
+    return false;
+  }
+
+  return is_header_current(header, source_info, vertex_format, flattened);
+}
+
+static bool is_range_valid(const u32 base_element, const u32 index_count, const u32 total_index_count) {
+  return base_element <= total_index_count && index_count <= total_index_count - base_element;
+}
+
+template <typename T> static bool are_indices_valid(const void *indices, const u32 index_count, const u32 vertex_count) {
+  const T *typed = static_cast<const T *>(indices);
+
+  T max_index = 0;
+
+  for (u32 i_index = 0; i_index < index_count; i_index++) {
+    max_index = typed[i_index] > max_index ? typed[i_index] : max_index;
+  }
+
+  return index_count == 0 || max_index < vertex_count;
+}
+
+bool read_cooked_source_hash(const u8 *data, const usize size, u64 &out_hash) {
+  if (size < sizeof(CookedHeader)) {
+    return false;
+  }
+
+  CookedHeader header;
+  memcpy(&header, data, sizeof(CookedHeader));
+
+  if (header.magic != cooked_magic || header.version != cooked_version) {
+    return false;
+  }
+
+  out_hash = header.source_hash;
+
+  return true;
+}
+
+utils::Result parse_cooked(const u8 *data, const usize size, CookedModel &out_model) {
+  if (size < sizeof(CookedHeader)) {
+    return utils::Result::error("cooked file truncated");
+  }
+
+  CookedHeader header;
+  memcpy(&header, data, sizeof(CookedHeader));
+
+  const auto in_bounds = [&](const u64 offset, const u64 count, const u64 element_size) {
+    return offset % cooked_alignment == 0 && offset <= size && count * element_size <= size - offset;
+  };
+
+  if (header.magic != cooked_magic || header.version != cooked_version ||
+      header.vertex_format > static_cast<u32>(comps::MeshBuffer::VertexFormat::QUANTIZED) ||
+      header.index_format > static_cast<u32>(comps::MeshBuffer::IndexFormat::U32)) {
+    return utils::Result::error("cooked file corrupt");
+  }
+
+  const auto vertex_format = static_cast<comps::MeshBuffer::VertexFormat>(header.vertex_format);
+  const auto index_format = static_cast<comps::MeshBuffer::IndexFormat>(header.index_format);
+
+  if (!in_bounds(header.vertex_offset, header.vertex_count, comps::MeshBuffer::get_vertex_size(vertex_format)) ||
+      !in_bounds(header.index_offset, header.index_count, comps::MeshBuffer::get_index_size(index_format)) ||
+      !in_bounds(header.mesh_offset, header.mesh_count, sizeof(comps::Mesh)) ||
+      !in_bounds(header.node_offset, header.node_count, sizeof(CookedNode))) {
+    return utils::Result::error("cooked file corrupt");
+  }
+
+  out_model = {
+      .vertices = data + header.vertex_offset,
+      .vertex_count = header.vertex_count,
+      .vertex_format = vertex_format,
+      .flattened = header.flattened != 0,
+      .indices = data + header.index_offset,
+      .index_count = header.index_count,
+      .index_format = index_format,
+      .meshes = reinterpret_cast<const comps::Mesh *>(data + header.mesh_offset),
+      .mesh_count = header.mesh_count,
+      .nodes = reinterpret_cast<const CookedNode *>(data + header.node_offset),
+      .node_count = header.node_count,
+      .source_hash = header.source_hash,
+  };
+
+  // everything below is drawn as is, so a damaged file must not get out of range elements or vertices to the gpu
+  for (u32 i_mesh = 0; i_mesh < out_model.mesh_count; i_mesh++) {
+    const comps::Mesh &mesh = out_model.meshes[i_mesh];
+
+    if (!is_range_valid(mesh.base_element, mesh.index_count, out_model.index_count) ||
+        mesh.lod_count > comps::Mesh::max_lods) {
+      return utils::Result::error("cooked mesh out of range");
+    }
+
+    for (u32 i_lod = 0; i_lod < mesh.lod_count; i_lod++) {
+      if (!is_range_valid(mesh.lods[i_lod].base_element, mesh.lods[i_lod].index_count, out_model.index_count)) {
+        return utils::Result::error("cooked mesh lod out of range");
+      }
+    }
+  }
+
+  const bool indices_valid =
+      index_format == comps::MeshBuffer::IndexFormat::U16
+          ? are_indices_valid<u16>(out_model.indices, out_model.index_count, out_model.vertex_count)
+          : are_indices_valid<u32>(out_model.indices, out_model.index_count, out_model.vertex_count);
+
+  if (!indices_valid) {
+    return utils::Result::error("cooked index out of range");
+  }
+
+  for (u32 i_node = 0; i_node < out_model.node_count; i_node++) {
+    const CookedNode &node = out_model.nodes[i_node];
+
+    if (node.mesh >= static_cast<i32>(out_model.mesh_count)) {
+      return utils::Result::error("cooked node references a missing mesh");
+    }
+
+    // instantiation relies on the pre-order, parents come before their children
+    if (node.parent < -1 || node.parent >= static_cast<i32>(i_node)) {
+      return utils::Result::error("cooked node references an invalid parent");
+    }
+  }
+
+  return utils::Result::ok();
+}
+
+utils::Result map_cooked(const c8 *source_path, const comps::MeshBuffer::VertexFormat vertex_format,
+                         const bool flattened, utils::MappedFile &out_file, CookedModel &out_model) {
+  c8 cooked_path[cooked_path_size];
+
+  if (!make_cooked_path(source_path, vertex_format, flattened, cooked_path)) {
+    return utils::Result::error("cooked path too long");
+  }
+
+  if (!out_file.open(cooked_path)) {
+    return utils::Result::error("can't map cooked file");
+  }
+
+  // the mapping is page aligned, so every 16 byte aligned offset is too
+  if (!parse_cooked(out_file.data, out_file.size, out_model)) {
+    out_file.close();
+    return utils::Result::error("can't parse mapped cooked file");
+  }
+
+  return utils::Result::ok();
+}
+
+utils::Result write_cooked(const c8 *source_path, const CookedModel &model) {
+  c8 cooked_path[cooked_path_size];
+  c8 temp_path[cooked_path_size + 16];
+
+  if (!make_cooked_path(source_path, model.vertex_format, model.flattened, cooked_path)) {
+    return utils::Result::error("cooked path too long");
+  }
+
+  utils::FileInfo source_info;
+
+  if (!utils::get_file_info(source_path, source_info)) {
+    return utils::Result::error("can't stat the cook source");
+  }
+
+  const usize vertex_size = comps::MeshBuffer::get_vertex_size(model.vertex_format);
+  const usize index_size = comps::MeshBuffer::get_index_size(model.index_format);
+
+  CookedHeader header = {
+      .magic = cooked_magic,
+      .version = cooked_version,
+      .source_size = source_info.size,
+      .source_modified_time = source_info.modified_time,
+      .source_hash = model.source_hash,
+      .vertex_format = static_cast<u32>(model.vertex_format),
+      .flattened = model.flattened ? 1u : 0u,
+      .index_format = static_cast<u32>(model.index_format),
+      .vertex_size = static_cast<u32>(vertex_size),
+      .index_size = static_cast<u32>(index_size),
+      .mesh_size = sizeof(comps::Mesh),
+      .node_size = sizeof(CookedNode),
+      .vertex_count = model.vertex_count,
+      .index_count = model.index_count,
+      .mesh_count = model.mesh_count,
+      .node_count = model.node_count,
+      .reserved = 0,
+      .vertex_offset = 0,
+      .index_offset = 0,
+      .mesh_offset = 0,
+      .node_offset = 0,
+  };
+
+  header.vertex_offset = align_offset(sizeof(CookedHeader));
+  header.index_offset = align_offset(header.vertex_offset + model.vertex_count * vertex_size);
+  header.mesh_offset = align_offset(header.index_offset + model.index_count * index_size);
+  header.node_offset = align_offset(header.mesh_offset + model.mesh_count * sizeof(comps::Mesh));
+
+  // written next to the target and renamed, so a crash never leaves a half written cooked file behind. numbered so
+  // writers running at the same time never share one
+  static std::atomic<u32> temp_counter = 0;
+
+  const u32 temp_number = temp_counter.fetch_add(1, std::memory_order_relaxed);
+  snprintf(temp_path, sizeof(temp_path), "%s.%u.tmp", cooked_path, temp_number);
+
+  FILE *file = fopen(temp_path, "wb");
+
+  if (file == nullptr) {
+    return utils::Result::error("can't open cooked file for writing");
+  }
+
+  const auto write_at = [&](const u64 offset, const void *data, const usize size) {
+    return fseek(file, static_cast<long>(offset), SEEK_SET) == 0 && (size == 0 || fwrite(data, size, 1, file) == 1);
+  };
+
+  const bool success =
+      write_at(0, &header, sizeof(CookedHeader)) &&
+      write_at(header.vertex_offset, model.vertices, model.vertex_count * vertex_size) &&
+      write_at(header.index_offset, model.indices, model.index_count * index_size) &&
+      write_at(header.mesh_offset, model.meshes, model.mesh_count * sizeof(comps::Mesh)) &&
+      write_at(header.node_offset, model.nodes, model.node_count * sizeof(CookedNode));
+
+  if (fclose(file) != 0 || !success) {
+    remove(temp_path);
+    return utils::Result::error("can't write cooked file");
+  }
+
+  remove(cooked_path);
+
+  if (rename(temp_path, cooked_path) != 0) {
+    remove(temp_path);
+    return utils::Result::error("can't rename cooked file");
+  }
+
+  return utils::Result::ok();
+}
+
+} // namespace assets
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "components.hpp"
+#include "file.hpp"
+
+namespace assets {
+
+// binary model next to its source file, the payloads are stored in their runtime layout so loading is a mmap
+
+constexpr u32 cooked_magic = 0x4d54424c; // "LBTM"
+constexpr u32 cooked_version = 8;
+
+// appended to the source path after the import options, every option set gets its own file
+constexpr const c8 *cooked_extension = ".cooked";
+
+constexpr usize cooked_path_size = 512;
+
+struct CookedHeader {
+  u32 magic;
+  u32 version;
+
+  // the source file the model was cooked from, a mismatch means the cooked file is stale
+  u64 source_size;
+  i64 source_modified_time;
+
+  // content hash of the source, so a cooked load is recognized as a duplicate of the gltf it came from
+  u64 source_hash;
+
+  // cooked with other import options means stale as well
+  u32 vertex_format;
+  u32 flattened;
+
+  // picked by vertex count, so no import option
+  u32 index_format;
+
+  // guard against layout changes that forgot to bump the version
+  u32 vertex_size;
+  u32 index_size;
+  u32 mesh_size;
+  u32 node_size;
+
+  u32 vertex_count;
+  u32 index_count;
+  u32 mesh_count;
+  u32 node_count;
+
+  // written as zero, keeps the offsets aligned without implicit padding going to disk
+  u32 reserved;
+
+  // from the start of the file, 16 byte aligned
+  u64 vertex_offset;
+  u64 index_offset;
+  u64 mesh_offset;
+  u64 node_offset;
+};
+
+struct CookedNode {
+  HMM_Vec3 translation;
+  HMM_Quat rotation;
+
+  // into the mesh table, -1 if the node has no mesh
+  i32 mesh;
+
+  // nodes are stored in pre-order, so the parent's index is always lower, -1 for roots
+  i32 parent;
+};
+
+// views into either a mapped cooked file or the arrays built from a gltf file
+struct CookedModel {
+  // Vertex or QuantizedVertex depending on the format
+  const void *vertices;
+  u32 vertex_count;
+  comps::MeshBuffer::VertexFormat vertex_format;
+
+  // node transforms baked into the vertices, the import option it was cooked with
+  bool flattened;
+
+  // u16 or u32 depending on the format
+  const void *indices;
+  u32 index_count;
+  comps::MeshBuffer::IndexFormat index_format;
+
+  const comps::Mesh *meshes;
+  u32 mesh_count;
+
+  const CookedNode *nodes;
+  u32 node_count;
+
+  // of the gltf file the model was decoded or cooked from
+  u64 source_hash;
+};
+
+// <source>.<vertex format>[.flat].cooked, false if the path doesn't fit
+[[nodiscard]] bool make_cooked_path(const c8 *source_path, const comps::MeshBuffer::VertexFormat vertex_format,
+                                    const bool flattened, c8 (&out_path)[cooked_path_size]);
+
+// false if there is no cooked file for the source or it is stale, from another version or cooked with other options
+[[nodiscard]] bool is_cooked_current(const c8 *source_path, const comps::MeshBuffer::VertexFormat vertex_format,
+                                     const bool flattened);
+
+// reads only the header, false if data doesn't start with one of this version
+[[nodiscard]] bool read_cooked_source_hash(const u8 *data, const usize size, u64 &out_hash);
+
+// the views point into data, which has to be 16 byte aligned
+utils::Result parse_cooked(const u8 *data, const usize size, CookedModel &out_model);
+
+// the views stay valid until the file is closed
+utils::Result map_cooked(const c8 *source_path, const comps::MeshBuffer::VertexFormat vertex_format,
+                         const bool flattened, utils::MappedFile &out_file, CookedModel &out_model);
+
+utils::Result write_cooked(const c8 *source_path, const CookedModel &model);
+
+} // namespace assets
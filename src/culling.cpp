@@ -0,0 +1,187 @@
+#include "culling.hpp"
+#include <bit>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CULLING_SSE
+#include <immintrin.h>
+#endif
+
+#if defined(CULLING_SSE) && defined(__GNUC__)
+#define CULLING_AVX
+#endif
+
+namespace culling {
+
+Frustum make_frustum(const HMM_Mat4 &view_projection) {
+  const HMM_Mat4 &m = view_projection;
+
+  const HMM_Vec4 row_x = HMM_V4(m.Elements[0][0], m.Elements[1][0], m.Elements[2][0], m.Elements[3][0]);
+  const HMM_Vec4 row_y = HMM_V4(m.Elements[0][1], m.Elements[1][1], m.Elements[2][1], m.Elements[3][1]);
+  const HMM_Vec4 row_z = HMM_V4(m.Elements[0][2], m.Elements[1][2], m.Elements[2][2], m.Elements[3][2]);
+  const HMM_Vec4 row_w = HMM_V4(m.Elements[0][3], m.Elements[1][3], m.Elements[2][3], m.Elements[3][3]);
+
+  Frustum frustum = {.planes = {
+                         row_w + row_x, // left
+                         row_w - row_x, // right
+                         row_w + row_y, // bottom
+                         row_w - row_y, // top
+                         row_z,         // near
+                         row_w - row_z, // far
+                     }};
+
+  for (HMM_Vec4 &plane : frustum.planes) {
+    plane = plane / HMM_LenV3(plane.XYZ);
+  }
+
+  return frustum;
+}
+
+void Spheres::clear() {
+  x.resize(0);
+  y.resize(0);
+  z.resize(0);
+  radius.resize(0);
+}
+
+void Spheres::push(const HMM_Vec3 center, const f32 sphere_radius) {
+  x.emplace_back(f32(center.X));
+  y.emplace_back(f32(center.Y));
+  z.emplace_back(f32(center.Z));
+  radius.emplace_back(f32(sphere_radius));
+}
+
+void Spheres::release() {
+  x.release();
+  y.release();
+  z.release();
+  radius.release();
+}
+
+static usize cull_spheres_scalar(const Frustum &frustum, const f32 *x, const f32 *y, const f32 *z, const f32 *radius,
+                                 const usize begin, const usize end, u8 *out_visible) {
+  usize visible_count = 0;
+
+  for (usize i = begin; i < end; i++) {
+    bool visible = true;
+
+    for (const HMM_Vec4 &plane : frustum.planes) {
+      const f32 distance = plane.X * x[i] + plane.Y * y[i] + plane.Z * z[i] + plane.W;
+
+      visible &= distance >= -radius[i];
+    }
+
+    out_visible[i] = visible;
+    visible_count += visible;
+  }
+
+  return visible_count;
+}
+
+#ifdef CULLING_SSE
+
+static usize cull_spheres_sse(const Frustum &frustum, const f32 *x, const f32 *y, const f32 *z, const f32 *radius,
+                              const usize count, u8 *out_visible) {
+  constexpr usize width = 4;
+
+  const usize simd_count = count - count % width;
+
+  usize visible_count = 0;
+
+  for (usize i = 0; i < simd_count; i += width) {
+    const __m128 sx = _mm_loadu_ps(x + i);
+    const __m128 sy = _mm_loadu_ps(y + i);
+    const __m128 sz = _mm_loadu_ps(z + i);
+    const __m128 neg_radius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+
+    __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+    for (const HMM_Vec4 &plane : frustum.planes) {
+      __m128 distance = _mm_mul_ps(sx, _mm_set1_ps(plane.X));
+      distance = _mm_add_ps(distance, _mm_mul_ps(sy, _mm_set1_ps(plane.Y)));
+      distance = _mm_add_ps(distance, _mm_mul_ps(sz, _mm_set1_ps(plane.Z)));
+      distance = _mm_add_ps(distance, _mm_set1_ps(plane.W));
+
+      inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, neg_radius));
+    }
+
+    const i32 mask = _mm_movemask_ps(inside);
+
+    for (usize lane = 0; lane < width; lane++) {
+      out_visible[i + lane] = (mask >> lane) & 1;
+    }
+
+    visible_count += std::popcount(static_cast<u32>(mask));
+  }
+
+  return visible_count + cull_spheres_scalar(frustum, x, y, z, radius, simd_count, count, out_visible);
+}
+
+#endif
+
+#ifdef CULLING_AVX
+
+__attribute__((target("avx"))) static usize cull_spheres_avx(const Frustum &frustum, const f32 *x, const f32 *y,
+                                                             const f32 *z, const f32 *radius, const usize count,
+                                                             u8 *out_visible) {
+  constexpr usize width = 8;
+
+  const usize simd_count = count - count % width;
+
+  usize visible_count = 0;
+
+  for (usize i = 0; i < simd_count; i += width) {
+    const __m256 sx = _mm256_loadu_ps(x + i);
+    const __m256 sy = _mm256_loadu_ps(y + i);
+    const __m256 sz = _mm256_loadu_ps(z + i);
+    const __m256 neg_radius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(radius + i));
+
+    __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+    for (const HMM_Vec4 &plane : frustum.planes) {
+      __m256 distance = _mm256_mul_ps(sx, _mm256_set1_ps(plane.X));
+      distance = _mm256_add_ps(distance, _mm256_mul_ps(sy, _mm256_set1_ps(plane.Y)));
+      distance = _mm256_add_ps(distance, _mm256_mul_ps(sz, _mm256_set1_ps(plane.Z)));
+      distance = _mm256_add_ps(distance, _mm256_set1_ps(plane.W));
+
+      inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, neg_radius, _CMP_GE_OQ));
+    }
+
+    const i32 mask = _mm256_movemask_ps(inside);
+
+    for (usize lane = 0; lane < width; lane++) {
+      out_visible[i + lane] = (mask >> lane) & 1;
+    }
+
+    visible_count += std::popcount(static_cast<u32>(mask));
+  }
+
+  return visible_count + cull_spheres_scalar(frustum, x, y, z, radius, simd_count, count, out_visible);
+}
+
+#endif
+
+usize cull_spheres(const Frustum &frustum, const f32 *x, const f32 *y, const f32 *z, const f32 *radius,
+                   const usize count, u8 *out_visible) {
+#ifdef CULLING_AVX
+  static const bool has_avx = __builtin_cpu_supports("avx");
+
+  if (has_avx) {
+    return cull_spheres_avx(frustum, x, y, z, radius, count, out_visible);
+  }
+#endif
+
+#ifdef CULLING_SSE
+  return cull_spheres_sse(frustum, x, y, z, radius, count, out_visible);
+#else
+  return cull_spheres_scalar(frustum, x, y, z, radius, 0, count, out_visible);
+#endif
+}
+
+usize cull_spheres(const Frustum &frustum, Spheres &spheres, utils::DSArray<u8> &out_visible) {
+  out_visible.resize(spheres.size());
+
+  return cull_spheres(frustum, spheres.x.data(), spheres.y.data(), spheres.z.data(), spheres.radius.data(),
+                      spheres.size(), out_visible.data());
+}
+
+} // namespace culling
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "engine.hpp"
+
+namespace culling {
+
+struct Frustum {
+  // xyz = normal pointing inside, w = distance
+  HMM_Vec4 planes[6];
+};
+
+// extracts the planes of a zero-to-one depth range projection
+[[nodiscard]] Frustum make_frustum(const HMM_Mat4 &view_projection);
+
+// bounding spheres in SoA layout for the cull kernel
+struct Spheres {
+  utils::DSArray<f32> x;
+  utils::DSArray<f32> y;
+  utils::DSArray<f32> z;
+  utils::DSArray<f32> radius;
+
+  [[nodiscard]] usize size() const { return x.size(); }
+
+  void clear();
+  void push(const HMM_Vec3 center, const f32 radius);
+  void release();
+};
+
+// writes 1 for every sphere intersecting the frustum and 0 otherwise, returns the visible count
+usize cull_spheres(const Frustum &frustum, const f32 *x, const f32 *y, const f32 *z, const f32 *radius,
+                   const usize count, u8 *out_visible);
+
+usize cull_spheres(const Frustum &frustum, Spheres &spheres, utils::DSArray<u8> &out_visible);
+
+} // namespace culling
@@ -6,6 +6,8 @@
 #include "types.hpp"
 #include <cstdio>
 #include <cstdlib>
+#include <new>
+#include <type_traits>
 #include <utility>
 
 // logging
@@ -66,7 +68,7 @@ public:
   Owner() = default;
   explicit Owner(T *value) : _value(value){};
   Owner(const Owner &) = delete;
-  Owner(Owner &&other) { *this = other; };
+  Owner(Owner &&other) { *this = std::move(other); };
 
   Owner &operator=(Owner &&other) {
     // LOG_ASSERT(_value == nullptr);
@@ -87,6 +89,11 @@ public:
     return Owner(value);
   }
 
+  // runs the constructor for types that aren't valid zeroed, pair with destroy
+  template <typename... Args> static Owner construct(Args &&...args) {
+    return Owner(new (aligned_alloc_16(sizeof(T))) T(std::forward<Args>(args)...));
+  }
+
   [[nodiscard]] constexpr T *get() { return _value; }
 
   void release() {
@@ -94,6 +101,14 @@ public:
     _value = nullptr;
   }
 
+  void destroy() {
+    if (_value != nullptr) {
+      _value->~T();
+    }
+
+    release();
+  }
+
   friend struct NonOwner<T>;
 };
 
@@ -190,12 +205,18 @@ public:
   DSArray(DSArray<T> &&) = delete;
 
   constexpr T *data() { return _ds_arr; }
+  constexpr const T *data() const { return _ds_arr; }
 
   constexpr T &operator[](const usize i) {
     LOG_ASSERT(i < arrlenu(_ds_arr));
     return _ds_arr[i];
   }
 
+  constexpr const T &operator[](const usize i) const {
+    LOG_ASSERT(i < arrlenu(_ds_arr));
+    return _ds_arr[i];
+  }
+
   usize size() const { return arrlen(_ds_arr); }
 
   void resize(const usize new_len) { arrsetlen(_ds_arr, new_len); }
@@ -203,6 +224,64 @@ public:
   void release() { arrfree(_ds_arr); }
 };
 
+// DSArray's interface over arena memory for transient data, the arena frees it so release only forgets it
+template <typename T> struct ArenaArray {
+  static_assert(std::is_trivially_copyable_v<T>);
+
+private:
+  Arena *_arena;
+  T *_data = nullptr;
+  usize _size = 0;
+  usize _capacity = 0;
+
+public:
+  explicit ArenaArray(Arena &arena) : _arena(&arena) {}
+  ArenaArray(const ArenaArray<T> &) = delete;
+  ArenaArray(ArenaArray<T> &&) = delete;
+
+  constexpr T *data() { return _data; }
+  constexpr const T *data() const { return _data; }
+
+  constexpr T &operator[](const usize i) {
+    LOG_ASSERT(i < _size);
+    return _data[i];
+  }
+
+  constexpr const T &operator[](const usize i) const {
+    LOG_ASSERT(i < _size);
+    return _data[i];
+  }
+
+  usize size() const { return _size; }
+
+  void reserve(const usize capacity) {
+    if (capacity <= _capacity) {
+      return;
+    }
+
+    const usize new_capacity = capacity > _capacity * 2 ? capacity : _capacity * 2;
+
+    _data = static_cast<T *>(_arena->realloc(_data, _capacity * sizeof(T), new_capacity * sizeof(T)));
+    _capacity = new_capacity;
+  }
+
+  void resize(const usize new_len) {
+    reserve(new_len);
+    _size = new_len;
+  }
+
+  void emplace_back(T &&item) {
+    reserve(_size + 1);
+    _data[_size++] = std::forward<T>(item);
+  }
+
+  void release() {
+    _data = nullptr;
+    _size = 0;
+    _capacity = 0;
+  }
+};
+
 // template <typename K, typename V> struct DSMap {
 
 //   struct Item {
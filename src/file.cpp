@@ -0,0 +1,140 @@
+#include "file.hpp"
+#include <filesystem>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace utils {
+
+bool get_file_info(const c8 *path, FileInfo &out_info) {
+  std::error_code error;
+
+  const std::uintmax_t size = std::filesystem::file_size(path, error);
+
+  if (error) {
+    return false;
+  }
+
+  const std::filesystem::file_time_type modified_time = std::filesystem::last_write_time(path, error);
+
+  if (error) {
+    return false;
+  }
+
+  out_info = {
+      .size = static_cast<u64>(size),
+      .modified_time = static_cast<i64>(modified_time.time_since_epoch().count()),
+  };
+
+  return true;
+}
+
+#ifdef _WIN32
+
+Result MappedFile::open(const c8 *path) {
+  LOG_ASSERT(data == nullptr);
+
+  _file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+  if (_file == INVALID_HANDLE_VALUE) {
+    _file = nullptr;
+    return Result::error("can't open file for mapping");
+  }
+
+  LARGE_INTEGER file_size;
+
+  if (!GetFileSizeEx(_file, &file_size) || file_size.QuadPart == 0) {
+    close();
+    return Result::error("can't map an empty file");
+  }
+
+  _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+  if (_mapping == nullptr) {
+    close();
+    return Result::error("CreateFileMappingA failed");
+  }
+
+  data = static_cast<const u8 *>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+
+  if (data == nullptr) {
+    close();
+    return Result::error("MapViewOfFile failed");
+  }
+
+  size = static_cast<usize>(file_size.QuadPart);
+
+  return Result::ok();
+}
+
+void MappedFile::close() {
+  if (data != nullptr) {
+    UnmapViewOfFile(data);
+  }
+
+  if (_mapping != nullptr) {
+    CloseHandle(_mapping);
+  }
+
+  if (_file != nullptr) {
+    CloseHandle(_file);
+  }
+
+  data = nullptr;
+  size = 0;
+  _file = nullptr;
+  _mapping = nullptr;
+}
+
+#else
+
+Result MappedFile::open(const c8 *path) {
+  LOG_ASSERT(data == nullptr);
+
+  const int fd = ::open(path, O_RDONLY);
+
+  if (fd < 0) {
+    return Result::error("can't open file for mapping");
+  }
+
+  struct stat file_stat;
+
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+    ::close(fd);
+    return Result::error("can't map an empty file");
+  }
+
+  void *mapping = mmap(nullptr, static_cast<usize>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+  // the mapping keeps its own reference to the file
+  ::close(fd);
+
+  if (mapping == MAP_FAILED) {
+    return Result::error("mmap failed");
+  }
+
+  data = static_cast<const u8 *>(mapping);
+  size = static_cast<usize>(file_stat.st_size);
+
+  return Result::ok();
+}
+
+void MappedFile::close() {
+  if (data != nullptr) {
+    munmap(const_cast<u8 *>(data), size);
+  }
+
+  data = nullptr;
+  size = 0;
+}
+
+#endif
+
+} // namespace utils
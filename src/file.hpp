@@ -0,0 +1,32 @@
+#pragma once
+
+#include "engine.hpp"
+
+namespace utils {
+
+struct FileInfo {
+  u64 size;
+
+  // opaque, only meaningful when compared with another FileInfo of the same file
+  i64 modified_time;
+};
+
+// false if the file doesn't exist
+[[nodiscard]] bool get_file_info(const c8 *path, FileInfo &out_info);
+
+// read only mapping of a whole file, the pages are loaded on first access
+struct MappedFile {
+  const u8 *data = nullptr;
+  usize size = 0;
+
+#ifdef _WIN32
+  void *_file = nullptr;
+  void *_mapping = nullptr;
+#endif
+
+  Result open(const c8 *path);
+
+  void close();
+};
+
+} // namespace utils
@@ -0,0 +1,1212 @@
+#include "geometry.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define GEOMETRY_SSE
+#include <immintrin.h>
+#endif
+
+namespace geometry {
+
+static const u8 *get_accessor_data(const cgltf_accessor *accessor) {
+  if (accessor->buffer_view == nullptr) {
+    return nullptr;
+  }
+
+  const u8 *view_data = cgltf_buffer_view_data(accessor->buffer_view);
+
+  if (view_data == nullptr) {
+    return nullptr;
+  }
+
+  return view_data + accessor->offset;
+}
+
+bool is_bulk_readable(const cgltf_accessor *accessor, const cgltf_type type) {
+  return accessor->type == type && accessor->component_type == cgltf_component_type_r_32f &&
+         accessor->normalized == 0 && accessor->is_sparse == 0 && get_accessor_data(accessor) != nullptr;
+}
+
+bool is_bulk_readable(const VertexAccessors &accessors) {
+  return is_bulk_readable(accessors.position, cgltf_type_vec3) && is_bulk_readable(accessors.normal, cgltf_type_vec3) &&
+         is_bulk_readable(accessors.texcoord, cgltf_type_vec2);
+}
+
+void unpack_vertices_generic(const VertexAccessors &accessors, comps::MeshBuffer::Vertex *out_vertices,
+                             HMM_Vec3 &out_min, HMM_Vec3 &out_max) {
+  HMM_Vec3 bounds_min = HMM_V3(INFINITY, INFINITY, INFINITY);
+  HMM_Vec3 bounds_max = HMM_V3(-INFINITY, -INFINITY, -INFINITY);
+
+  for (cgltf_size i_component = 0; i_component < accessors.position->count; i_component++) {
+    comps::MeshBuffer::Vertex vertex;
+
+    constexpr usize tmp_count = 3;
+    f32 tmp[tmp_count];
+
+    LOG_ASSERT(cgltf_accessor_read_float(accessors.position, i_component, tmp, tmp_count));
+    vertex.position[0] = tmp[0];
+    vertex.position[1] = tmp[1];
+    vertex.position[2] = tmp[2];
+
+    bounds_min = HMM_V3(HMM_MIN(bounds_min.X, tmp[0]), HMM_MIN(bounds_min.Y, tmp[1]), HMM_MIN(bounds_min.Z, tmp[2]));
+    bounds_max = HMM_V3(HMM_MAX(bounds_max.X, tmp[0]), HMM_MAX(bounds_max.Y, tmp[1]), HMM_MAX(bounds_max.Z, tmp[2]));
+
+    LOG_ASSERT(cgltf_accessor_read_float(accessors.normal, i_component, tmp, tmp_count));
+    vertex.normal[0] = tmp[0];
+    vertex.normal[1] = tmp[1];
+    vertex.normal[2] = tmp[2];
+
+    LOG_ASSERT(cgltf_accessor_read_float(accessors.texcoord, i_component, tmp, tmp_count));
+    vertex.uv[0] = tmp[0];
+    vertex.uv[1] = tmp[1];
+
+    out_vertices[i_component] = vertex;
+  }
+
+  out_min = bounds_min;
+  out_max = bounds_max;
+}
+
+static void interleave_scalar(const u8 *positions, const u8 *normals, const u8 *texcoords,
+                              const VertexAccessors &accessors, comps::MeshBuffer::Vertex *out_vertices,
+                              const usize begin, const usize end, HMM_Vec3 &bounds_min, HMM_Vec3 &bounds_max) {
+  for (usize i = begin; i < end; i++) {
+    comps::MeshBuffer::Vertex &vertex = out_vertices[i];
+
+    memcpy(vertex.position, positions + i * accessors.position->stride, sizeof(vertex.position));
+    memcpy(vertex.normal, normals + i * accessors.normal->stride, sizeof(vertex.normal));
+    memcpy(vertex.uv, texcoords + i * accessors.texcoord->stride, sizeof(vertex.uv));
+
+    bounds_min = HMM_V3(HMM_MIN(bounds_min.X, vertex.position[0]), HMM_MIN(bounds_min.Y, vertex.position[1]),
+                        HMM_MIN(bounds_min.Z, vertex.position[2]));
+    bounds_max = HMM_V3(HMM_MAX(bounds_max.X, vertex.position[0]), HMM_MAX(bounds_max.Y, vertex.position[1]),
+                        HMM_MAX(bounds_max.Z, vertex.position[2]));
+  }
+}
+
+void unpack_vertices_bulk(const VertexAccessors &accessors, comps::MeshBuffer::Vertex *out_vertices,
+                          HMM_Vec3 &out_min, HMM_Vec3 &out_max) {
+  static_assert(sizeof(comps::MeshBuffer::Vertex) == 8 * sizeof(f32));
+
+  LOG_ASSERT(is_bulk_readable(accessors));
+
+  const u8 *positions = get_accessor_data(accessors.position);
+  const u8 *normals = get_accessor_data(accessors.normal);
+  const u8 *texcoords = get_accessor_data(accessors.texcoord);
+
+  const usize count = accessors.position->count;
+
+  HMM_Vec3 bounds_min = HMM_V3(INFINITY, INFINITY, INFINITY);
+  HMM_Vec3 bounds_max = HMM_V3(-INFINITY, -INFINITY, -INFINITY);
+
+  usize simd_end = 0;
+
+#ifdef GEOMETRY_SSE
+  // the vec3 loads read one float past the element, which is still inside the next one, so the last vertex is scalar
+  simd_end = count > 0 ? count - 1 : 0;
+
+  const usize position_stride = accessors.position->stride;
+  const usize normal_stride = accessors.normal->stride;
+  const usize texcoord_stride = accessors.texcoord->stride;
+
+  __m128 simd_min = _mm_set1_ps(INFINITY);
+  __m128 simd_max = _mm_set1_ps(-INFINITY);
+
+  f32 *out = out_vertices->position;
+
+  for (usize i = 0; i < simd_end; i++) {
+    const __m128 p = _mm_loadu_ps(reinterpret_cast<const f32 *>(positions + i * position_stride));
+    const __m128 n = _mm_loadu_ps(reinterpret_cast<const f32 *>(normals + i * normal_stride));
+    const __m128 t = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const f64 *>(texcoords + i * texcoord_stride)));
+
+    // [px py pz nx] [ny nz u v]
+    const __m128 pz_nx = _mm_shuffle_ps(p, n, _MM_SHUFFLE(0, 0, 2, 2));
+    const __m128 low = _mm_shuffle_ps(p, pz_nx, _MM_SHUFFLE(2, 0, 1, 0));
+    const __m128 high = _mm_shuffle_ps(n, t, _MM_SHUFFLE(1, 0, 2, 1));
+
+    _mm_storeu_ps(out + i * 8, low);
+    _mm_storeu_ps(out + i * 8 + 4, high);
+
+    // the fourth lane is never read back
+    simd_min = _mm_min_ps(simd_min, p);
+    simd_max = _mm_max_ps(simd_max, p);
+  }
+
+  alignas(16) f32 lanes[4];
+
+  _mm_store_ps(lanes, simd_min);
+  bounds_min = HMM_V3(lanes[0], lanes[1], lanes[2]);
+
+  _mm_store_ps(lanes, simd_max);
+  bounds_max = HMM_V3(lanes[0], lanes[1], lanes[2]);
+#endif
+
+  interleave_scalar(positions, normals, texcoords, accessors, out_vertices, simd_end, count, bounds_min, bounds_max);
+
+  out_min = bounds_min;
+  out_max = bounds_max;
+}
+
+void unpack_indices_generic(const cgltf_accessor *accessor, const u32 base_vertex, u32 *out_indices) {
+  for (cgltf_size i_index = 0; i_index < accessor->count; i_index++) {
+    out_indices[i_index] = static_cast<u32>(cgltf_accessor_read_index(accessor, i_index)) + base_vertex;
+  }
+}
+
+template <typename T>
+static void convert_indices(const u8 *data, const usize stride, const usize count, const u32 base_vertex,
+                            u32 *out_indices) {
+  if constexpr (std::is_same_v<T, u32>) {
+    if (stride == sizeof(T) && base_vertex == 0) {
+      memcpy(out_indices, data, count * sizeof(T));
+      return;
+    }
+  }
+
+  for (usize i = 0; i < count; i++) {
+    T index;
+    memcpy(&index, data + i * stride, sizeof(T));
+
+    out_indices[i] = static_cast<u32>(index) + base_vertex;
+  }
+}
+
+bool unpack_indices_bulk(const cgltf_accessor *accessor, const u32 base_vertex, u32 *out_indices) {
+  if (accessor->is_sparse != 0 || accessor->type != cgltf_type_scalar) {
+    return false;
+  }
+
+  const u8 *data = get_accessor_data(accessor);
+
+  if (data == nullptr) {
+    return false;
+  }
+
+  switch (accessor->component_type) {
+  case cgltf_component_type_r_8u:
+    convert_indices<u8>(data, accessor->stride, accessor->count, base_vertex, out_indices);
+    return true;
+  case cgltf_component_type_r_16u:
+    convert_indices<u16>(data, accessor->stride, accessor->count, base_vertex, out_indices);
+    return true;
+  case cgltf_component_type_r_32u:
+    convert_indices<u32>(data, accessor->stride, accessor->count, base_vertex, out_indices);
+    return true;
+  default:
+    return false;
+  }
+}
+
+// mesh optimization
+
+VertexCacheStats analyze_vertex_cache(const u32 *indices, const usize index_count, const usize vertex_count) {
+  if (index_count < 3 || vertex_count == 0) {
+    return {.acmr = 0.0f, .atvr = 0.0f};
+  }
+
+  // a vertex is cached while fewer than vertex_cache_size misses happened since it was loaded
+  utils::DSArray<u32> load_times;
+  load_times.resize(vertex_count);
+  memset(load_times.data(), 0, vertex_count * sizeof(u32));
+
+  u32 time = vertex_cache_size + 1;
+  usize misses = 0;
+
+  for (usize i = 0; i < index_count; i++) {
+    const u32 vertex = indices[i];
+
+    if (time - load_times[vertex] > vertex_cache_size) {
+      load_times[vertex] = time++;
+      misses++;
+    }
+  }
+
+  load_times.release();
+
+  return {
+      .acmr = static_cast<f32>(misses) / static_cast<f32>(index_count / 3),
+      .atvr = static_cast<f32>(misses) / static_cast<f32>(vertex_count),
+  };
+}
+
+static u32 hash_vertex(const comps::MeshBuffer::Vertex &vertex) {
+  u32 words[sizeof(comps::MeshBuffer::Vertex) / sizeof(u32)];
+  memcpy(words, &vertex, sizeof(words));
+
+  u32 hash = 2166136261u;
+
+  for (const u32 word : words) {
+    hash = (hash ^ word) * 16777619u;
+    hash ^= hash >> 15;
+  }
+
+  return hash;
+}
+
+usize deduplicate_vertices(comps::MeshBuffer::Vertex *vertices, const usize vertex_count, u32 *indices,
+                           const usize index_count) {
+  constexpr u32 empty = std::numeric_limits<u32>::max();
+
+  usize table_size = 16;
+
+  while (table_size < vertex_count * 2) {
+    table_size *= 2;
+  }
+
+  const usize table_mask = table_size - 1;
+
+  utils::DSArray<u32> table;
+  table.resize(table_size);
+  memset(table.data(), 0xff, table_size * sizeof(u32));
+
+  utils::DSArray<u32> remap;
+  remap.resize(vertex_count);
+
+  // unique vertices are compacted in place, every slot below unique_count is already final
+  usize unique_count = 0;
+
+  for (usize i_vertex = 0; i_vertex < vertex_count; i_vertex++) {
+    usize slot = hash_vertex(vertices[i_vertex]) & table_mask;
+
+    while (true) {
+      const u32 unique = table[slot];
+
+      if (unique == empty) {
+        table[slot] = static_cast<u32>(unique_count);
+        vertices[unique_count] = vertices[i_vertex];
+        remap[i_vertex] = static_cast<u32>(unique_count);
+        unique_count++;
+        break;
+      }
+
+      if (memcmp(&vertices[unique], &vertices[i_vertex], sizeof(comps::MeshBuffer::Vertex)) == 0) {
+        remap[i_vertex] = unique;
+        break;
+      }
+
+      slot = (slot + 1) & table_mask;
+    }
+  }
+
+  for (usize i = 0; i < index_count; i++) {
+    indices[i] = remap[indices[i]];
+  }
+
+  table.release();
+  remap.release();
+
+  return unique_count;
+}
+
+// tuning from the original write up, the scoring cache is larger than the simulated one on purpose
+namespace forsyth {
+
+constexpr u32 cache_size = 32;
+constexpr f32 cache_decay_power = 1.5f;
+constexpr f32 last_triangle_score = 0.75f;
+constexpr f32 valence_boost_scale = 2.0f;
+constexpr f32 valence_boost_power = 0.5f;
+
+static f32 score_vertex(const i32 cache_position, const u32 remaining_triangles) {
+  if (remaining_triangles == 0) {
+    return -1.0f;
+  }
+
+  f32 score = 0.0f;
+
+  if (cache_position >= 0) {
+    if (cache_position < 3) {
+      // the last triangle's vertices, fixed so its neighbours don't get picked over others sharing an edge
+      score = last_triangle_score;
+    } else {
+      const f32 scaler = 1.0f / static_cast<f32>(cache_size - 3);
+      score = powf(1.0f - static_cast<f32>(cache_position - 3) * scaler, cache_decay_power);
+    }
+  }
+
+  // vertices with few triangles left are finished first, so they leave the cache for good
+  return score + valence_boost_scale * powf(static_cast<f32>(remaining_triangles), -valence_boost_power);
+}
+
+} // namespace forsyth
+
+void optimize_vertex_cache(u32 *indices, const usize index_count, const usize vertex_count) {
+  const usize triangle_count = index_count / 3;
+
+  if (triangle_count == 0) {
+    return;
+  }
+
+  // triangles per vertex, the first remaining_triangles of each list are still to be emitted
+
+  utils::DSArray<u32> remaining_triangles;
+  utils::DSArray<u32> adjacency_offsets;
+  utils::DSArray<u32> adjacency;
+
+  remaining_triangles.resize(vertex_count);
+  adjacency_offsets.resize(vertex_count);
+  adjacency.resize(triangle_count * 3);
+
+  memset(remaining_triangles.data(), 0, vertex_count * sizeof(u32));
+
+  for (usize i = 0; i < triangle_count * 3; i++) {
+    remaining_triangles[indices[i]]++;
+  }
+
+  u32 offset = 0;
+
+  for (usize i_vertex = 0; i_vertex < vertex_count; i_vertex++) {
+    adjacency_offsets[i_vertex] = offset;
+    offset += remaining_triangles[i_vertex];
+  }
+
+  // counts are rebuilt while filling the lists
+  memset(remaining_triangles.data(), 0, vertex_count * sizeof(u32));
+
+  for (usize i = 0; i < triangle_count * 3; i++) {
+    const u32 vertex = indices[i];
+    adjacency[adjacency_offsets[vertex] + remaining_triangles[vertex]++] = static_cast<u32>(i / 3);
+  }
+
+  utils::DSArray<i32> cache_positions;
+  utils::DSArray<f32> vertex_scores;
+  utils::DSArray<u8> emitted;
+  utils::DSArray<u32> output;
+
+  cache_positions.resize(vertex_count);
+  vertex_scores.resize(vertex_count);
+  emitted.resize(triangle_count);
+  output.resize(triangle_count * 3);
+
+  memset(emitted.data(), 0, triangle_count);
+
+  for (usize i_vertex = 0; i_vertex < vertex_count; i_vertex++) {
+    cache_positions[i_vertex] = -1;
+    vertex_scores[i_vertex] = forsyth::score_vertex(-1, remaining_triangles[i_vertex]);
+  }
+
+  u32 cache[forsyth::cache_size + 3];
+  u32 cache_count = 0;
+
+  usize scan_cursor = 0;
+  i64 best_triangle = -1;
+
+  for (usize i_output = 0; i_output < triangle_count; i_output++) {
+    // nothing left around the cache, continue with the next triangle in input order
+    if (best_triangle < 0) {
+      while (emitted[scan_cursor] != 0) {
+        scan_cursor++;
+      }
+
+      best_triangle = static_cast<i64>(scan_cursor);
+    }
+
+    const usize triangle = static_cast<usize>(best_triangle);
+    const u32 *triangle_indices = &indices[triangle * 3];
+
+    emitted[triangle] = 1;
+    memcpy(&output[i_output * 3], triangle_indices, 3 * sizeof(u32));
+
+    for (usize k = 0; k < 3; k++) {
+      const u32 vertex = triangle_indices[k];
+      u32 *triangles = &adjacency[adjacency_offsets[vertex]];
+      u32 &remaining = remaining_triangles[vertex];
+
+      for (u32 i_triangle = 0; i_triangle < remaining; i_triangle++) {
+        if (triangles[i_triangle] == triangle) {
+          triangles[i_triangle] = triangles[remaining - 1];
+          remaining--;
+          break;
+        }
+      }
+    }
+
+    // lru, the triangle's vertices move to the front
+
+    u32 new_cache[forsyth::cache_size + 3];
+    u32 new_cache_count = 0;
+
+    for (usize k = 0; k < 3; k++) {
+      const u32 vertex = triangle_indices[k];
+
+      if (std::find(new_cache, new_cache + new_cache_count, vertex) == new_cache + new_cache_count) {
+        new_cache[new_cache_count++] = vertex;
+      }
+    }
+
+    for (u32 i_cache = 0; i_cache < cache_count; i_cache++) {
+      const u32 vertex = cache[i_cache];
+
+      if (vertex != triangle_indices[0] && vertex != triangle_indices[1] && vertex != triangle_indices[2]) {
+        new_cache[new_cache_count++] = vertex;
+      }
+    }
+
+    for (u32 i_cache = forsyth::cache_size; i_cache < new_cache_count; i_cache++) {
+      const u32 vertex = new_cache[i_cache];
+
+      cache_positions[vertex] = -1;
+      vertex_scores[vertex] = forsyth::score_vertex(-1, remaining_triangles[vertex]);
+    }
+
+    cache_count = HMM_MIN(new_cache_count, forsyth::cache_size);
+    memcpy(cache, new_cache, cache_count * sizeof(u32));
+
+    for (u32 i_cache = 0; i_cache < cache_count; i_cache++) {
+      const u32 vertex = cache[i_cache];
+
+      cache_positions[vertex] = static_cast<i32>(i_cache);
+      vertex_scores[vertex] = forsyth::score_vertex(static_cast<i32>(i_cache), remaining_triangles[vertex]);
+    }
+
+    // only triangles touching the cache changed score, the best of them goes next
+
+    best_triangle = -1;
+    f32 best_score = -1.0f;
+
+    for (u32 i_cache = 0; i_cache < cache_count; i_cache++) {
+      const u32 vertex = cache[i_cache];
+      const u32 *triangles = &adjacency[adjacency_offsets[vertex]];
+
+      for (u32 i_triangle = 0; i_triangle < remaining_triangles[vertex]; i_triangle++) {
+        const u32 candidate = triangles[i_triangle];
+        const u32 *candidate_indices = &indices[candidate * 3];
+
+        const f32 score = vertex_scores[candidate_indices[0]] + vertex_scores[candidate_indices[1]] +
+                          vertex_scores[candidate_indices[2]];
+
+        if (score > best_score) {
+          best_score = score;
+          best_triangle = candidate;
+        }
+      }
+    }
+  }
+
+  memcpy(indices, output.data(), triangle_count * 3 * sizeof(u32));
+
+  remaining_triangles.release();
+  adjacency_offsets.release();
+  adjacency.release();
+  cache_positions.release();
+  vertex_scores.release();
+  emitted.release();
+  output.release();
+}
+
+void optimize_overdraw(u32 *indices, const usize index_count, const comps::MeshBuffer::Vertex *vertices,
+                       const usize vertex_count) {
+  const usize triangle_count = index_count / 3;
+
+  if (triangle_count < 2) {
+    return;
+  }
+
+  // a triangle missing the simulated cache on every vertex starts a cluster, so moving clusters keeps the hit rate
+
+  utils::DSArray<u32> load_times;
+  load_times.resize(vertex_count);
+  memset(load_times.data(), 0, vertex_count * sizeof(u32));
+
+  utils::DSArray<u32> cluster_starts;
+
+  u32 time = vertex_cache_size + 1;
+
+  for (usize i_triangle = 0; i_triangle < triangle_count; i_triangle++) {
+    u32 misses = 0;
+
+    for (usize k = 0; k < 3; k++) {
+      const u32 vertex = indices[i_triangle * 3 + k];
+
+      if (time - load_times[vertex] > vertex_cache_size) {
+        load_times[vertex] = time++;
+        misses++;
+      }
+    }
+
+    if (misses == 3 || i_triangle == 0) {
+      cluster_starts.emplace_back(static_cast<u32>(i_triangle));
+    }
+  }
+
+  const usize cluster_count = cluster_starts.size();
+
+  load_times.release();
+
+  if (cluster_count < 2) {
+    cluster_starts.release();
+    return;
+  }
+
+  // area weighted centroid and normal of every cluster
+
+  struct Cluster {
+    u32 begin;
+    u32 end;
+    HMM_Vec3 centroid;
+    HMM_Vec3 normal;
+    f32 area;
+    f32 sort_key;
+  };
+
+  utils::DSArray<Cluster> clusters;
+  clusters.resize(cluster_count);
+
+  HMM_Vec3 mesh_centroid = HMM_V3(0.0f, 0.0f, 0.0f);
+  f32 mesh_area = 0.0f;
+
+  const auto get_position = [&](const u32 vertex) {
+    return HMM_V3(vertices[vertex].position[0], vertices[vertex].position[1], vertices[vertex].position[2]);
+  };
+
+  for (usize i_cluster = 0; i_cluster < cluster_count; i_cluster++) {
+    Cluster &cluster = clusters[i_cluster];
+
+    cluster = {
+        .begin = cluster_starts[i_cluster],
+        .end = i_cluster + 1 < cluster_count ? cluster_starts[i_cluster + 1] : static_cast<u32>(triangle_count),
+        .centroid = HMM_V3(0.0f, 0.0f, 0.0f),
+        .normal = HMM_V3(0.0f, 0.0f, 0.0f),
+        .area = 0.0f,
+        .sort_key = 0.0f,
+    };
+
+    for (u32 i_triangle = cluster.begin; i_triangle < cluster.end; i_triangle++) {
+      const HMM_Vec3 a = get_position(indices[i_triangle * 3 + 0]);
+      const HMM_Vec3 b = get_position(indices[i_triangle * 3 + 1]);
+      const HMM_Vec3 c = get_position(indices[i_triangle * 3 + 2]);
+
+      // twice the area, which cancels out
+      const HMM_Vec3 normal = HMM_Cross(b - a, c - a);
+      const f32 area = HMM_LenV3(normal);
+
+      cluster.centroid += (a + b + c) * (area / 3.0f);
+      cluster.normal += normal;
+      cluster.area += area;
+    }
+
+    mesh_centroid += cluster.centroid;
+    mesh_area += cluster.area;
+
+    if (cluster.area > 0.0f) {
+      cluster.centroid = cluster.centroid / cluster.area;
+    }
+  }
+
+  if (mesh_area > 0.0f) {
+    mesh_centroid = mesh_centroid / mesh_area;
+  }
+
+  // clusters facing away from the center occlude the ones behind them from most view directions
+  utils::DSArray<u32> order;
+  order.resize(cluster_count);
+
+  for (usize i_cluster = 0; i_cluster < cluster_count; i_cluster++) {
+    Cluster &cluster = clusters[i_cluster];
+
+    const f32 normal_length = HMM_LenV3(cluster.normal);
+
+    cluster.sort_key =
+        normal_length > 0.0f ? HMM_DotV3(cluster.centroid - mesh_centroid, cluster.normal / normal_length) : 0.0f;
+
+    order[i_cluster] = static_cast<u32>(i_cluster);
+  }
+
+  std::stable_sort(order.data(), order.data() + cluster_count,
+                   [&](const u32 a, const u32 b) { return clusters[a].sort_key > clusters[b].sort_key; });
+
+  utils::DSArray<u32> output;
+  output.resize(triangle_count * 3);
+
+  usize output_count = 0;
+
+  for (usize i_order = 0; i_order < cluster_count; i_order++) {
+    const Cluster &cluster = clusters[order[i_order]];
+    const usize cluster_index_count = (cluster.end - cluster.begin) * 3;
+
+    memcpy(&output[output_count], &indices[cluster.begin * 3], cluster_index_count * sizeof(u32));
+    output_count += cluster_index_count;
+  }
+
+  memcpy(indices, output.data(), triangle_count * 3 * sizeof(u32));
+
+  cluster_starts.release();
+  clusters.release();
+  order.release();
+  output.release();
+}
+
+usize optimize_vertex_fetch(comps::MeshBuffer::Vertex *vertices, const usize vertex_count, u32 *indices,
+                            const usize index_count) {
+  constexpr u32 unused = std::numeric_limits<u32>::max();
+
+  utils::DSArray<u32> remap;
+  remap.resize(vertex_count);
+  memset(remap.data(), 0xff, vertex_count * sizeof(u32));
+
+  u32 used_count = 0;
+
+  for (usize i = 0; i < index_count; i++) {
+    u32 &new_index = remap[indices[i]];
+
+    if (new_index == unused) {
+      new_index = used_count++;
+    }
+
+    indices[i] = new_index;
+  }
+
+  utils::DSArray<comps::MeshBuffer::Vertex> reordered;
+  reordered.resize(used_count);
+
+  for (usize i_vertex = 0; i_vertex < vertex_count; i_vertex++) {
+    if (remap[i_vertex] != unused) {
+      reordered[remap[i_vertex]] = vertices[i_vertex];
+    }
+  }
+
+  memcpy(vertices, reordered.data(), used_count * sizeof(comps::MeshBuffer::Vertex));
+
+  remap.release();
+  reordered.release();
+
+  return used_count;
+}
+
+// quadric error metrics, garland and heckbert, with collapses restricted to existing vertices
+namespace qem {
+
+// symmetric 4x4 of the summed plane equations, weighted by triangle area
+struct Quadric {
+  f64 a2, ab, ac, ad;
+  f64 b2, bc, bd;
+  f64 c2, cd;
+  f64 d2;
+  f64 weight;
+};
+
+static Quadric make_plane(const HMM_Vec3 normal, const f32 distance, const f64 weight) {
+  const f64 a = normal.X;
+  const f64 b = normal.Y;
+  const f64 c = normal.Z;
+  const f64 d = distance;
+
+  return {
+      .a2 = a * a * weight,
+      .ab = a * b * weight,
+      .ac = a * c * weight,
+      .ad = a * d * weight,
+      .b2 = b * b * weight,
+      .bc = b * c * weight,
+      .bd = b * d * weight,
+      .c2 = c * c * weight,
+      .cd = c * d * weight,
+      .d2 = d * d * weight,
+      .weight = weight,
+  };
+}
+
+static void add(Quadric &q, const Quadric &other) {
+  q.a2 += other.a2;
+  q.ab += other.ab;
+  q.ac += other.ac;
+  q.ad += other.ad;
+  q.b2 += other.b2;
+  q.bc += other.bc;
+  q.bd += other.bd;
+  q.c2 += other.c2;
+  q.cd += other.cd;
+  q.d2 += other.d2;
+  q.weight += other.weight;
+}
+
+// weighted mean of the squared distances to the planes
+static f64 evaluate(const Quadric &q, const HMM_Vec3 p) {
+  const f64 x = p.X;
+  const f64 y = p.Y;
+  const f64 z = p.Z;
+
+  const f64 error = q.a2 * x * x + q.b2 * y * y + q.c2 * z * z + 2.0 * (q.ab * x * y + q.ac * x * z + q.bc * y * z) +
+                    2.0 * (q.ad * x + q.bd * y + q.cd * z) + q.d2;
+
+  return q.weight > 0.0 ? HMM_MAX(error, 0.0) / q.weight : 0.0;
+}
+
+} // namespace qem
+
+static u32 hash_position(const f32 *position) {
+  u32 words[3];
+  memcpy(words, position, sizeof(words));
+
+  return (words[0] * 73856093u) ^ (words[1] * 19349663u) ^ (words[2] * 83492791u);
+}
+
+usize simplify(const u32 *indices, const usize index_count, const comps::MeshBuffer::Vertex *vertices,
+               const usize vertex_count, const usize target_index_count, u32 *out_indices, f32 &out_error) {
+  constexpr u32 empty = std::numeric_limits<u32>::max();
+
+  out_error = 0.0f;
+
+  memcpy(out_indices, indices, index_count * sizeof(u32));
+
+  if (index_count <= target_index_count || vertex_count == 0) {
+    return index_count;
+  }
+
+  const auto get_position = [&](const u32 vertex) {
+    return HMM_V3(vertices[vertex].position[0], vertices[vertex].position[1], vertices[vertex].position[2]);
+  };
+
+  const auto get_normal = [&](const u32 vertex) {
+    return HMM_V3(vertices[vertex].normal[0], vertices[vertex].normal[1], vertices[vertex].normal[2]);
+  };
+
+  // vertices split for normals or uvs share a position, the first one of them stands in for all
+
+  usize table_size = 16;
+
+  while (table_size < vertex_count * 2) {
+    table_size *= 2;
+  }
+
+  const usize table_mask = table_size - 1;
+
+  utils::DSArray<u32> table;
+  table.resize(table_size);
+  memset(table.data(), 0xff, table_size * sizeof(u32));
+
+  utils::DSArray<u32> welded;
+  welded.resize(vertex_count);
+
+  // circular list through every vertex at the same position
+  utils::DSArray<u32> siblings;
+  siblings.resize(vertex_count);
+
+  for (usize i_vertex = 0; i_vertex < vertex_count; i_vertex++) {
+    usize slot = hash_position(vertices[i_vertex].position) & table_mask;
+    const u32 vertex = static_cast<u32>(i_vertex);
+
+    while (true) {
+      const u32 first = table[slot];
+
+      if (first == empty) {
+        table[slot] = vertex;
+        welded[vertex] = vertex;
+        siblings[vertex] = vertex;
+        break;
+      }
+
+      if (memcmp(vertices[first].position, vertices[vertex].position, sizeof(vertices[vertex].position)) == 0) {
+        welded[vertex] = first;
+        siblings[vertex] = siblings[first];
+        siblings[first] = vertex;
+        break;
+      }
+
+      slot = (slot + 1) & table_mask;
+    }
+  }
+
+  table.release();
+
+  utils::DSArray<qem::Quadric> quadrics;
+  quadrics.resize(vertex_count);
+  memset(quadrics.data(), 0, vertex_count * sizeof(qem::Quadric));
+
+  for (usize i = 0; i < index_count; i += 3) {
+    const HMM_Vec3 a = get_position(out_indices[i + 0]);
+    const HMM_Vec3 b = get_position(out_indices[i + 1]);
+    const HMM_Vec3 c = get_position(out_indices[i + 2]);
+
+    const HMM_Vec3 normal = HMM_Cross(b - a, c - a);
+    const f32 length = HMM_LenV3(normal);
+
+    if (length <= 0.0f) {
+      continue;
+    }
+
+    const HMM_Vec3 unit_normal = normal / length;
+    const qem::Quadric plane = qem::make_plane(unit_normal, -HMM_DotV3(unit_normal, a), length * 0.5f);
+
+    for (usize k = 0; k < 3; k++) {
+      qem::add(quadrics[welded[out_indices[i + k]]], plane);
+    }
+  }
+
+  struct Collapse {
+    u32 from;
+    u32 to;
+    f64 error;
+  };
+
+  utils::DSArray<u64> edges;
+  utils::DSArray<Collapse> collapses;
+  utils::DSArray<u8> locked;
+  utils::DSArray<u32> collapse_target;
+  utils::DSArray<u32> adjacency_offsets;
+  utils::DSArray<u32> adjacency;
+
+  locked.resize(vertex_count);
+  collapse_target.resize(vertex_count);
+  adjacency_offsets.resize(vertex_count + 1);
+
+  for (usize i_vertex = 0; i_vertex < vertex_count; i_vertex++) {
+    collapse_target[i_vertex] = static_cast<u32>(i_vertex);
+  }
+
+  usize current_count = index_count;
+  f64 max_error = 0.0;
+
+  // every pass collapses the cheapest edges that don't share a neighbourhood, so the costs stay valid within it
+  while (current_count > target_index_count) {
+    const usize triangle_count = current_count / 3;
+
+    edges.resize(0);
+
+    for (usize i = 0; i < current_count; i += 3) {
+      for (usize k = 0; k < 3; k++) {
+        const u64 a = welded[out_indices[i + k]];
+        const u64 b = welded[out_indices[i + (k + 1) % 3]];
+
+        edges.emplace_back(HMM_MIN(a, b) << 32 | HMM_MAX(a, b));
+      }
+    }
+
+    std::sort(edges.data(), edges.data() + edges.size());
+
+    // open borders and non manifold edges would tear, their vertices stay where they are
+    memset(locked.data(), 0, vertex_count);
+
+    usize unique_edge_count = 0;
+
+    for (usize i_edge = 0; i_edge < edges.size();) {
+      usize i_end = i_edge + 1;
+
+      while (i_end < edges.size() && edges[i_end] == edges[i_edge]) {
+        i_end++;
+      }
+
+      const u32 a = static_cast<u32>(edges[i_edge] >> 32);
+      const u32 b = static_cast<u32>(edges[i_edge] & 0xffffffff);
+
+      if (i_end - i_edge != 2) {
+        locked[a] = 1;
+        locked[b] = 1;
+      }
+
+      edges[unique_edge_count++] = edges[i_edge];
+      i_edge = i_end;
+    }
+
+    collapses.resize(0);
+
+    for (usize i_edge = 0; i_edge < unique_edge_count; i_edge++) {
+      const u32 a = static_cast<u32>(edges[i_edge] >> 32);
+      const u32 b = static_cast<u32>(edges[i_edge] & 0xffffffff);
+
+      if (locked[a] && locked[b]) {
+        continue;
+      }
+
+      qem::Quadric merged = quadrics[a];
+      qem::add(merged, quadrics[b]);
+
+      const f64 error_ab = locked[a] ? std::numeric_limits<f64>::max() : qem::evaluate(merged, get_position(b));
+      const f64 error_ba = locked[b] ? std::numeric_limits<f64>::max() : qem::evaluate(merged, get_position(a));
+
+      collapses.emplace_back(error_ab <= error_ba ? Collapse{.from = a, .to = b, .error = error_ab}
+                                                  : Collapse{.from = b, .to = a, .error = error_ba});
+    }
+
+    if (collapses.size() == 0) {
+      break;
+    }
+
+    std::sort(collapses.data(), collapses.data() + collapses.size(),
+              [](const Collapse &a, const Collapse &b) { return a.error < b.error; });
+
+    // triangles around every welded vertex
+
+    memset(adjacency_offsets.data(), 0, (vertex_count + 1) * sizeof(u32));
+
+    for (usize i = 0; i < current_count; i++) {
+      adjacency_offsets[welded[out_indices[i]] + 1]++;
+    }
+
+    for (usize i_vertex = 0; i_vertex < vertex_count; i_vertex++) {
+      adjacency_offsets[i_vertex + 1] += adjacency_offsets[i_vertex];
+    }
+
+    adjacency.resize(current_count);
+
+    for (usize i = 0; i < current_count; i++) {
+      const u32 vertex = welded[out_indices[i]];
+
+      adjacency[adjacency_offsets[vertex]++] = static_cast<u32>(i / 3);
+    }
+
+    // the fill advanced every offset to the next vertex's start
+    for (usize i_vertex = vertex_count; i_vertex > 0; i_vertex--) {
+      adjacency_offsets[i_vertex] = adjacency_offsets[i_vertex - 1];
+    }
+
+    adjacency_offsets[0] = 0;
+
+    // locked doubles as the set of vertices a collapse in this pass already touched
+    usize remaining_triangles = triangle_count;
+    usize collapse_count = 0;
+
+    for (usize i_collapse = 0; i_collapse < collapses.size(); i_collapse++) {
+      if (remaining_triangles * 3 <= target_index_count) {
+        break;
+      }
+
+      const Collapse &collapse = collapses[i_collapse];
+
+      if (locked[collapse.from] || locked[collapse.to]) {
+        continue;
+      }
+
+      const HMM_Vec3 target = get_position(collapse.to);
+
+      bool flips = false;
+      usize removed = 0;
+
+      for (u32 i_adjacent = adjacency_offsets[collapse.from]; i_adjacent < adjacency_offsets[collapse.from + 1];
+           i_adjacent++) {
+        const u32 *triangle = &out_indices[adjacency[i_adjacent] * 3];
+
+        HMM_Vec3 corners[3];
+        HMM_Vec3 moved[3];
+        bool contains_target = false;
+
+        for (usize k = 0; k < 3; k++) {
+          const u32 vertex = welded[triangle[k]];
+
+          corners[k] = get_position(vertex);
+          moved[k] = vertex == collapse.from ? target : corners[k];
+          contains_target |= vertex == collapse.to;
+        }
+
+        if (contains_target) {
+          removed++;
+          continue;
+        }
+
+        const HMM_Vec3 normal = HMM_Cross(corners[1] - corners[0], corners[2] - corners[0]);
+        const HMM_Vec3 moved_normal = HMM_Cross(moved[1] - moved[0], moved[2] - moved[0]);
+
+        if (HMM_DotV3(normal, moved_normal) <= 0.0f) {
+          flips = true;
+          break;
+        }
+      }
+
+      if (flips) {
+        continue;
+      }
+
+      collapse_target[collapse.from] = collapse.to;
+      qem::add(quadrics[collapse.to], quadrics[collapse.from]);
+
+      for (u32 i_adjacent = adjacency_offsets[collapse.from]; i_adjacent < adjacency_offsets[collapse.from + 1];
+           i_adjacent++) {
+        const u32 *triangle = &out_indices[adjacency[i_adjacent] * 3];
+
+        for (usize k = 0; k < 3; k++) {
+          locked[welded[triangle[k]]] = 1;
+        }
+      }
+
+      max_error = HMM_MAX(max_error, collapse.error);
+      remaining_triangles -= HMM_MIN(removed, remaining_triangles);
+      collapse_count++;
+    }
+
+    if (collapse_count == 0) {
+      break;
+    }
+
+    // moved corners take the vertex at the target whose normal is closest to their own, keeping hard edges sharp
+
+    usize write = 0;
+
+    for (usize i = 0; i < current_count; i += 3) {
+      u32 triangle[3];
+
+      for (usize k = 0; k < 3; k++) {
+        const u32 vertex = out_indices[i + k];
+        const u32 target = collapse_target[welded[vertex]];
+
+        triangle[k] = vertex;
+
+        if (target == welded[vertex]) {
+          continue;
+        }
+
+        const HMM_Vec3 normal = get_normal(vertex);
+
+        u32 best = target;
+        f32 best_dot = -std::numeric_limits<f32>::max();
+        u32 sibling = target;
+
+        do {
+          const f32 dot = HMM_DotV3(normal, get_normal(sibling));
+
+          if (dot > best_dot) {
+            best = sibling;
+            best_dot = dot;
+          }
+
+          sibling = siblings[sibling];
+        } while (sibling != target);
+
+        triangle[k] = best;
+      }
+
+      const u32 a = welded[triangle[0]];
+      const u32 b = welded[triangle[1]];
+      const u32 c = welded[triangle[2]];
+
+      if (a == b || b == c || c == a) {
+        continue;
+      }
+
+      out_indices[write++] = triangle[0];
+      out_indices[write++] = triangle[1];
+      out_indices[write++] = triangle[2];
+    }
+
+    for (usize i_vertex = 0; i_vertex < vertex_count; i_vertex++) {
+      collapse_target[i_vertex] = static_cast<u32>(i_vertex);
+    }
+
+    current_count = write;
+  }
+
+  welded.release();
+  siblings.release();
+  quadrics.release();
+  edges.release();
+  collapses.release();
+  locked.release();
+  collapse_target.release();
+  adjacency_offsets.release();
+  adjacency.release();
+
+  out_error = static_cast<f32>(sqrt(max_error));
+
+  return current_count;
+}
+
+void narrow_indices(const u32 *indices, const usize count, u16 *out_indices) {
+  for (usize i = 0; i < count; i++) {
+    LOG_ASSERT(indices[i] <= std::numeric_limits<u16>::max());
+
+    out_indices[i] = static_cast<u16>(indices[i]);
+  }
+}
+
+static i16 quantize_snorm16(const f32 value) {
+  return static_cast<i16>(roundf(HMM_Clamp(-1.0f, value, 1.0f) * 32767.0f));
+}
+
+// round to nearest even, overflow goes to infinity
+static u16 quantize_half(const f32 value) {
+  u32 bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  const u32 sign = (bits >> 16) & 0x8000;
+  const u32 float_exponent = (bits >> 23) & 0xff;
+  const i32 exponent = static_cast<i32>(float_exponent) - 127 + 15;
+
+  u32 mantissa = bits & 0x7fffff;
+
+  if (float_exponent == 0xff) {
+    return static_cast<u16>(sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0));
+  }
+
+  if (exponent >= 31) {
+    return static_cast<u16>(sign | 0x7c00);
+  }
+
+  u32 shift = 13;
+  u32 half;
+
+  if (exponent <= 0) {
+    if (exponent < -10) {
+      return static_cast<u16>(sign);
+    }
+
+    // subnormal, the implicit bit becomes explicit
+    mantissa |= 0x800000;
+    shift = static_cast<u32>(14 - exponent);
+    half = mantissa >> shift;
+  } else {
+    half = (static_cast<u32>(exponent) << 10) | (mantissa >> shift);
+  }
+
+  const u32 remainder = mantissa & ((1u << shift) - 1);
+  const u32 halfway = 1u << (shift - 1);
+
+  // a carry out of the mantissa correctly bumps the exponent
+  if (remainder > halfway || (remainder == halfway && (half & 1) != 0)) {
+    half++;
+  }
+
+  return static_cast<u16>(sign | half);
+}
+
+// octahedral mapping of the unit sphere onto [-1, 1]^2
+static HMM_Vec2 encode_octahedral(const f32 x, const f32 y, const f32 z) {
+  const f32 length = fabsf(x) + fabsf(y) + fabsf(z);
+
+  if (length == 0.0f) {
+    return HMM_V2(0.0f, 0.0f);
+  }
+
+  HMM_Vec2 encoded = HMM_V2(x / length, y / length);
+
+  if (z < 0.0f) {
+    encoded = HMM_V2((1.0f - fabsf(encoded.Y)) * (encoded.X >= 0.0f ? 1.0f : -1.0f),
+                     (1.0f - fabsf(encoded.X)) * (encoded.Y >= 0.0f ? 1.0f : -1.0f));
+  }
+
+  return encoded;
+}
+
+void quantize_vertices(const comps::MeshBuffer::Vertex *vertices, const usize count, const comps::Bounds &bounds,
+                       comps::MeshBuffer::QuantizedVertex *out_vertices) {
+  // flat axes have no extent, every position on them maps to the center
+  HMM_Vec3 inv_extents;
+
+  for (i32 i_axis = 0; i_axis < 3; i_axis++) {
+    const f32 extent = bounds.extents.Elements[i_axis];
+    inv_extents.Elements[i_axis] = extent > 0.0f ? 1.0f / extent : 0.0f;
+  }
+
+  for (usize i = 0; i < count; i++) {
+    const comps::MeshBuffer::Vertex &vertex = vertices[i];
+    comps::MeshBuffer::QuantizedVertex &out = out_vertices[i];
+
+    for (i32 i_axis = 0; i_axis < 3; i_axis++) {
+      const f32 relative = (vertex.position[i_axis] - bounds.center.Elements[i_axis]) * inv_extents.Elements[i_axis];
+      out.position[i_axis] = quantize_snorm16(relative);
+    }
+
+    out.position[3] = 0;
+
+    const HMM_Vec2 normal = encode_octahedral(vertex.normal[0], vertex.normal[1], vertex.normal[2]);
+    out.normal[0] = quantize_snorm16(normal.X);
+    out.normal[1] = quantize_snorm16(normal.Y);
+
+    out.uv[0] = quantize_half(vertex.uv[0]);
+    out.uv[1] = quantize_half(vertex.uv[1]);
+  }
+}
+
+} // namespace geometry
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "components.hpp"
+#include "thirdparty/cgltf/cgltf.h"
+
+namespace geometry {
+
+struct VertexAccessors {
+  const cgltf_accessor *position;
+  const cgltf_accessor *normal;
+  const cgltf_accessor *texcoord;
+};
+
+// float32 without normalization or sparse data, read straight from the buffer view
+[[nodiscard]] bool is_bulk_readable(const cgltf_accessor *accessor, const cgltf_type type);
+
+[[nodiscard]] bool is_bulk_readable(const VertexAccessors &accessors);
+
+// per element through cgltf, accepts every component type, writes accessors.position->count vertices
+void unpack_vertices_generic(const VertexAccessors &accessors, comps::MeshBuffer::Vertex *out_vertices,
+                             HMM_Vec3 &out_min, HMM_Vec3 &out_max);
+
+// strided copy and interleave, requires is_bulk_readable
+void unpack_vertices_bulk(const VertexAccessors &accessors, comps::MeshBuffer::Vertex *out_vertices,
+                          HMM_Vec3 &out_min, HMM_Vec3 &out_max);
+
+inline void unpack_vertices(const VertexAccessors &accessors, comps::MeshBuffer::Vertex *out_vertices,
+                            HMM_Vec3 &out_min, HMM_Vec3 &out_max) {
+  if (is_bulk_readable(accessors)) {
+    unpack_vertices_bulk(accessors, out_vertices, out_min, out_max);
+  } else {
+    unpack_vertices_generic(accessors, out_vertices, out_min, out_max);
+  }
+}
+
+// per element through cgltf, writes accessor->count indices with base_vertex added
+void unpack_indices_generic(const cgltf_accessor *accessor, const u32 base_vertex, u32 *out_indices);
+
+// converts u8, u16 and u32 indices in one pass, returns false for anything else
+[[nodiscard]] bool unpack_indices_bulk(const cgltf_accessor *accessor, const u32 base_vertex, u32 *out_indices);
+
+inline void unpack_indices(const cgltf_accessor *accessor, const u32 base_vertex, u32 *out_indices) {
+  if (!unpack_indices_bulk(accessor, base_vertex, out_indices)) {
+    unpack_indices_generic(accessor, base_vertex, out_indices);
+  }
+}
+
+// indices have to be below 65536
+void narrow_indices(const u32 *indices, const usize count, u16 *out_indices);
+
+// mesh optimization, indices are local to the vertices they are passed with
+
+struct VertexCacheStats {
+  // average cache miss ratio, transformed vertices per triangle, 0.5 is the best a regular grid gets
+  f32 acmr;
+
+  // average transform to vertex ratio, 1.0 means every vertex is transformed once
+  f32 atvr;
+};
+
+// fifo cache of the given size, the usual model for post transform caches
+constexpr u32 vertex_cache_size = 16;
+
+[[nodiscard]] VertexCacheStats analyze_vertex_cache(const u32 *indices, const usize index_count,
+                                                    const usize vertex_count);
+
+// merges bitwise equal vertices and rewrites the indices, returns the new vertex count
+[[nodiscard]] usize deduplicate_vertices(comps::MeshBuffer::Vertex *vertices, const usize vertex_count, u32 *indices,
+                                         const usize index_count);
+
+// reorders triangles for the post transform cache, forsyth's linear speed algorithm
+void optimize_vertex_cache(u32 *indices, const usize index_count, const usize vertex_count);
+
+// splits the cache ordered triangles where the cache restarts and draws outward facing clusters first
+void optimize_overdraw(u32 *indices, const usize index_count, const comps::MeshBuffer::Vertex *vertices,
+                       const usize vertex_count);
+
+// orders vertices by first use and drops unused ones, returns the new vertex count
+[[nodiscard]] usize optimize_vertex_fetch(comps::MeshBuffer::Vertex *vertices, const usize vertex_count, u32 *indices,
+                                          const usize index_count);
+
+// quadric error edge collapse until target_index_count is reached or no edge can collapse any more. the result only
+// references the given vertices, so lods share them. out_indices needs index_count space, returns the written count and
+// the largest collapse error as a distance in vertex space
+[[nodiscard]] usize simplify(const u32 *indices, const usize index_count, const comps::MeshBuffer::Vertex *vertices,
+                             const usize vertex_count, const usize target_index_count, u32 *out_indices,
+                             f32 &out_error);
+
+// bounds are the mesh's, positions outside of them are clamped
+void quantize_vertices(const comps::MeshBuffer::Vertex *vertices, const usize count, const comps::Bounds &bounds,
+                       comps::MeshBuffer::QuantizedVertex *out_vertices);
+
+} // namespace geometry
@@ -4,11 +4,19 @@
 #include "thirdparty/stb/stb_ds.h"
 
 #define SOKOL_IMPL
+#ifdef LBTL_HEADLESS
+// no window or gl context, every sokol_gfx call is a no-op
+#define SOKOL_DUMMY_BACKEND
+#include "thirdparty/sokol/sokol_gfx.h"
+#else
 #define SOKOL_GLCORE33
 #include "thirdparty/sokol/sokol_app.h"
 #include "thirdparty/sokol/sokol_gfx.h"
 #include "thirdparty/sokol/sokol_glue.h"
+#endif
+#include "thirdparty/sokol/sokol_fetch.h"
 #include "thirdparty/sokol/sokol_log.h"
+#include "thirdparty/sokol/sokol_time.h"
 
 #define CGLTF_MALLOC(size) utils::aligned_alloc_16(size)
 #define CGLTF_FREE(ptr) utils::aligned_free_16(ptr)
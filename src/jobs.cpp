@@ -0,0 +1,98 @@
+#include "jobs.hpp"
+#include "engine.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace jobs {
+
+struct Job {
+  Function function;
+  void *user_data;
+};
+
+constexpr u32 max_threads = 64;
+
+std::thread threads[max_threads];
+u32 thread_count = 0;
+
+std::mutex mutex;
+std::condition_variable condition;
+bool stopping = false;
+
+// fifo, popped from queue_head and compacted once empty
+utils::DSArray<Job> queue;
+usize queue_head = 0;
+
+static void worker() {
+  while (true) {
+    Job job;
+
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+
+      condition.wait(lock, [] { return stopping || queue_head < queue.size(); });
+
+      if (queue_head == queue.size()) {
+        return;
+      }
+
+      job = queue[queue_head++];
+
+      if (queue_head == queue.size()) {
+        queue.resize(0);
+        queue_head = 0;
+      }
+    }
+
+    job.function(job.user_data);
+  }
+}
+
+void init(u32 count) {
+  LOG_ASSERT(thread_count == 0);
+
+  if (count == 0) {
+    count = HMM_MAX(std::thread::hardware_concurrency() / 2, 1u);
+  }
+
+  thread_count = HMM_MIN(count, max_threads);
+  stopping = false;
+
+  for (u32 i_thread = 0; i_thread < thread_count; i_thread++) {
+    threads[i_thread] = std::thread(worker);
+  }
+}
+
+void push(const Function function, void *user_data) {
+  LOG_ASSERT(thread_count > 0);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    queue.emplace_back(Job{.function = function, .user_data = user_data});
+  }
+
+  condition.notify_one();
+}
+
+void finish() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    stopping = true;
+  }
+
+  condition.notify_all();
+
+  for (u32 i_thread = 0; i_thread < thread_count; i_thread++) {
+    threads[i_thread].join();
+  }
+
+  thread_count = 0;
+
+  queue.release();
+  queue_head = 0;
+}
+
+} // namespace jobs
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "types.hpp"
+
+namespace jobs {
+
+// background worker pool for long running tasks like asset decoding, frame work belongs in flecs systems
+
+using Function = void (*)(void *user_data);
+
+// 0 uses half of the hardware threads
+void init(u32 thread_count);
+
+// thread safe, jobs start in push order but may finish in any order
+void push(Function function, void *user_data);
+
+// runs the queued jobs to completion and joins the workers
+void finish();
+
+} // namespace jobs
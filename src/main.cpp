@@ -3,16 +3,95 @@
 #include "input.hpp"
 #include "physics.hpp"
 #include "player.hpp"
+#include "profile.hpp"
 #include "thirdparty/sokol/sokol_log.h"
+#include "thirdparty/sokol/sokol_time.h"
+#include <cstdlib>
 
 static void init(void) {
   LOG_DEBUG("Debug mode!")
 
+  stm_setup();
+
+  world::main.set_worker_count(0);
+
   renderer::init();
+  assets::init();
   physics::init();
   player::init();
 }
 
+static void run_frame(const f64 frame_time) {
+  utils::next_frame();
+
+  profile::begin_frame();
+
+  input::pre_frame();
+
+  // FixedUpdate physics ticks, then PreUpdate player, OnUpdate interpolation, PostUpdate transforms,
+  // PreStore collect and OnStore draw
+  world::main.advance(frame_time);
+
+  input::post_frame();
+
+  profile::end_frame();
+}
+
+constexpr const c8 *memory_report_path = "memory_report.txt";
+
+static void cleanup(void) {
+  world::main.finish();
+  assets::finish();
+  physics::finish();
+  renderer::finish();
+
+  utils::release_frame_arenas();
+  utils::assert_no_leaks();
+}
+
+#ifdef LBTL_HEADLESS
+
+// runs `lbtl-headless [frame count] [alloc sample rate]` frames at a fixed 60 Hz frame time and reports the profile
+// and memory, with a sample rate the sampled allocation sites are also written to memory_report.txt
+int main(int argc, char *argv[]) {
+  const u32 frame_count = argc > 1 ? static_cast<u32>(strtoul(argv[1], nullptr, 10)) : 1000;
+  const u32 sample_rate = argc > 2 ? static_cast<u32>(strtoul(argv[2], nullptr, 10)) : 0;
+
+  utils::set_alloc_sampling(sample_rate);
+
+  init();
+
+  // stream in the assets first, so every measured frame sees the whole scene
+  while (assets::is_loading()) {
+    run_frame(1.0 / 60.0);
+  }
+
+  profile::reset();
+
+  const u64 start = stm_now();
+
+  for (u32 i_frame = 0; i_frame < frame_count; i_frame++) {
+    run_frame(1.0 / 60.0);
+  }
+
+  LOG_INFO("headless: %u frames in %.3f ms", frame_count, stm_ms(stm_since(start)))
+
+  profile::report();
+  utils::report_memory();
+
+  if (sample_rate != 0 && !utils::write_memory_report(memory_report_path)) {
+    LOG_ERROR("memory report failed")
+  }
+
+  cleanup();
+
+  return 0;
+}
+
+#else
+
+static u64 last_frame_time = 0;
+
 static void event(const sapp_event *event) {
   if (event->type == SAPP_EVENTTYPE_MOUSE_MOVE) {
     input::handle_mousemove(HMM_V2(event->mouse_dx, event->mouse_dy));
@@ -21,6 +100,30 @@ static void event(const sapp_event *event) {
   } else if (event->type == SAPP_EVENTTYPE_KEY_DOWN) {
     if (event->key_code == SAPP_KEYCODE_ESCAPE) {
       sapp_request_quit();
+    } else if (event->key_code == SAPP_KEYCODE_F1) {
+      const renderer::Stats &stats = renderer::get_stats();
+
+      LOG_INFO("draw calls: %u, instances: %u, pipeline changes: %u, binding changes: %u, visible: %u, culled: %u, "
+               "simplified: %u, instancing: %d",
+               stats.draw_calls, stats.instances, stats.pipeline_changes, stats.binding_changes, stats.visible,
+               stats.culled, stats.simplified, renderer::get_instancing())
+
+      profile::report();
+    } else if (event->key_code == SAPP_KEYCODE_F2) {
+      utils::report_memory();
+
+      if (!utils::write_memory_report(memory_report_path)) {
+        LOG_ERROR("memory report failed")
+      }
+    } else if (event->key_code == SAPP_KEYCODE_F3) {
+      renderer::set_instancing(!renderer::get_instancing());
+
+      LOG_INFO("instancing: %d", renderer::get_instancing())
+    } else if (event->key_code == SAPP_KEYCODE_F4) {
+      // e.g. after switching modes, so the timings only cover one of them
+      profile::reset();
+
+      LOG_INFO("profile reset")
     }
 
     input::handle_keydown(event->key_code);
@@ -30,29 +133,8 @@ static void event(const sapp_event *event) {
 }
 
 static void frame(void) {
-  const float delta_time = 1.0f / 60.0f;
-
-  // pre frame
-  input::pre_frame();
-
-  // update
-  world::main.update();
-  physics::update(delta_time);
-  player::update();
-
-  // post frame
-  input::post_frame();
-
-  // draw
-  renderer::draw();
-}
-
-static void cleanup(void) {
-  assets::finish();
-  physics::init();
-  renderer::finish();
-
-  utils::assert_no_leaks();
+  // the first lap is 0, long stalls like a debugger break are clamped
+  run_frame(HMM_MIN(stm_sec(stm_laptime(&last_frame_time)), 0.25));
 }
 
 sapp_desc sokol_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
@@ -75,4 +157,6 @@ sapp_desc sokol_main([[maybe_unused]] int argc, [[maybe_unused]] char *argv[]) {
           },
       .win32_console_attach = true,
   };
-}
\ No newline at end of file
+}
+
+#endif
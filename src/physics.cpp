@@ -3,24 +3,42 @@
 #include "components.hpp"
 #include "thirdparty/HandmadeMath/HandmadeMath.h"
 #include "world.hpp"
+#include <new>
 
 namespace physics {
 
-static reactphysics3d::PhysicsCommon physicsCommon;
+// rp3d's base allocator, its heap, pool and single frame allocators take their memory from here, so physics shows up
+// in the telemetry and the leak check
+struct Allocator : public reactphysics3d::MemoryAllocator {
+  void *allocate(size_t size) override { return utils::aligned_alloc_16(size, utils::MemoryTag::PHYSICS); }
+
+  void release(void *pointer, [[maybe_unused]] size_t size) override { utils::aligned_free_16(pointer); }
+};
+
+static Allocator allocator;
+
+// created in init, rp3d holds on to its memory until it is destroyed
+static reactphysics3d::PhysicsCommon *physicsCommon = nullptr;
+
 reactphysics3d::PhysicsWorld *world = nullptr;
 
 void init() {
+  const utils::MemoryTagScope tag_scope(utils::MemoryTag::PHYSICS);
+
   reactphysics3d::PhysicsWorld::WorldSettings settings;
 
   settings.gravity = reactphysics3d::Vector3(0, 0, 0);
 
-  world = physicsCommon.createPhysicsWorld(settings);
+  physicsCommon = new (utils::aligned_alloc_16(sizeof(reactphysics3d::PhysicsCommon)))
+      reactphysics3d::PhysicsCommon(&allocator);
+
+  world = physicsCommon->createPhysicsWorld(settings);
 
-  world::main.observer<comps::Transform, comps::RigidBody>()
+  world::main.observer<const comps::LocalTransform, comps::RigidBody>()
       .event(flecs::OnSet)
-      .each([](comps::Transform &transform, comps::RigidBody &rigidbody) {
-        HMM_Vec3 &comp_translation = transform.translation;
-        HMM_Quat &comp_rotation = transform.rotation;
+      .each([](const comps::LocalTransform &local, comps::RigidBody &rigidbody) {
+        const HMM_Vec3 &comp_translation = local.translation;
+        const HMM_Quat &comp_rotation = local.rotation;
 
         rigidbody._rigidbody = world->createRigidBody(reactphysics3d::Transform(
             reactphysics3d::Vector3(comp_translation.X, comp_translation.Y, comp_translation.Z),
@@ -28,21 +46,72 @@ void init() {
 
         rigidbody._rigidbody->setLinearDamping(rigidbody.linear_damping);
         rigidbody._rigidbody->setAngularDamping(rigidbody.angular_damping);
-      });
-}
 
-void update(const float delta_time) {
-  world->update(delta_time);
+        rigidbody._previous_translation = comp_translation;
+        rigidbody._previous_rotation = comp_rotation;
+        rigidbody._current_translation = comp_translation;
+        rigidbody._current_rotation = comp_rotation;
+      });
 
-  world::main.query_transform_rigidbody.each([](comps::Transform &transform, comps::RigidBody &rigidbody) {
-    const reactphysics3d::Vector3 &react_position = rigidbody._rigidbody->getTransform().getPosition();
-    const reactphysics3d::Quaternion &react_orientation = rigidbody._rigidbody->getTransform().getOrientation();
+  world::main.system("physics_step").kind<world::FixedUpdate>().iter([](flecs::iter &it) {
+    const utils::MemoryTagScope tag_scope(utils::MemoryTag::PHYSICS);
 
-    transform.translation = HMM_V3(react_position.x, react_position.y, react_position.z);
-    transform.rotation = HMM_Q(react_orientation.x, react_orientation.y, react_orientation.z, react_orientation.w);
+    world->update(it.delta_time());
   });
+
+  // bodies only read their own state, so the sync is split across the workers
+  world::main.system<comps::RigidBody>("physics_sync")
+      .kind<world::FixedUpdate>()
+      .multi_threaded()
+      .each([](comps::RigidBody &rigidbody) {
+        const reactphysics3d::Vector3 &react_position = rigidbody._rigidbody->getTransform().getPosition();
+        const reactphysics3d::Quaternion &react_orientation = rigidbody._rigidbody->getTransform().getOrientation();
+
+        rigidbody._previous_translation = rigidbody._current_translation;
+        rigidbody._previous_rotation = rigidbody._current_rotation;
+
+        rigidbody._current_translation = HMM_V3(react_position.x, react_position.y, react_position.z);
+        rigidbody._current_rotation =
+            HMM_Q(react_orientation.x, react_orientation.y, react_orientation.z, react_orientation.w);
+      });
+
+  // only the 32 byte local transforms are touched here, the world matrices stay out of the cache
+  world::main.system<comps::LocalTransform, const comps::RigidBody>("physics_interpolate")
+      .kind(flecs::OnUpdate)
+      .multi_threaded()
+      .each([](comps::LocalTransform &local, const comps::RigidBody &rigidbody) {
+        const f32 alpha = world::main.get_interpolation_alpha();
+
+        HMM_Quat current_rotation = rigidbody._current_rotation;
+
+        // take the short way around
+        if (HMM_DotQ(rigidbody._previous_rotation, current_rotation) < 0.0f) {
+          current_rotation = HMM_MulQF(current_rotation, -1.0f);
+        }
+
+        const HMM_Vec3 translation =
+            HMM_LerpV3(rigidbody._previous_translation, alpha, rigidbody._current_translation);
+        const HMM_Quat rotation = HMM_NLerp(rigidbody._previous_rotation, alpha, current_rotation);
+
+        // resting bodies keep their transform clean
+        if (translation == local.translation && rotation.X == local.rotation.X && rotation.Y == local.rotation.Y &&
+            rotation.Z == local.rotation.Z && rotation.W == local.rotation.W) {
+          return;
+        }
+
+        local.translation = translation;
+        local.rotation = rotation;
+        local.dirty = true;
+      });
 }
 
-void finish() { physicsCommon.destroyPhysicsWorld(world); }
+void finish() {
+  physicsCommon->destroyPhysicsWorld(world);
+  world = nullptr;
+
+  physicsCommon->~PhysicsCommon();
+  utils::aligned_free_16(physicsCommon);
+  physicsCommon = nullptr;
+}
 
 } // namespace physics
@@ -4,10 +4,9 @@
 
 namespace physics {
 
+// registers the FixedUpdate step and sync systems and the OnUpdate interpolation system
 void init();
 
-void update(float delta_time);
-
 void finish();
 
 extern reactphysics3d::PhysicsWorld *world;
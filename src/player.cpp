@@ -11,32 +11,49 @@
 
 namespace player {
 
+constexpr f32 target_distance = 500.0f;
+
 flecs::entity player_root;
 flecs::entity player_head;
 
+static void update();
+
 void init() {
   const HMM_Vec2 width_height = renderer::get_width_height();
 
   player_root = world::main.entity()
-                    .set(comps::Transform{.translation = HMM_V3(0.0, 0.0, 0.0)})
+                    .set(comps::LocalTransform{.translation = HMM_V3(0.0, 0.0, 0.0)})
                     .set(comps::RigidBody{})
                     .set(comps::Player{});
   player_head = world::main.entity()
-                    .set(comps::Transform{.translation = HMM_V3(0.0, 2.0, 10.0)})
+                    .set(comps::LocalTransform{.translation = HMM_V3(0.0, 2.0, 10.0)})
                     .set(comps::Camera(0.25f, width_height.X / width_height.Y, 0.1f, 1000.0f))
                     .child_of(player_root);
 
   world::main.camera = player_head;
 
-  utils::NonOwner<assets::Prefab> prefab;
+  // the ship's nodes show up once the model is resident
+  const assets::LoadOptions ship_options = {
+      .vertex_format = comps::MeshBuffer::VertexFormat::QUANTIZED,
+      .flatten = true,
+  };
 
-  if (assets::load_model("./assets/glb/ships.glb", prefab)) {
-    flecs::entity space_ship = world::main.instantiate(prefab);
-    space_ship.get_mut<comps::Transform>()->translation.X = 0.01f;
-  }
+  const assets::PrefabHandle ship = assets::load_model_async("./assets/glb/ships.glb", ship_options);
+
+  flecs::entity space_ship = assets::instantiate(ship);
+
+  // the instance keeps the model alive from here on
+  assets::release_model(ship);
+  comps::LocalTransform &space_ship_local = *space_ship.get_mut<comps::LocalTransform>();
+
+  space_ship_local.translation.X = 0.01f;
+  space_ship_local.dirty = true;
+
+  // mutates components through get_mut, so it runs outside of readonly mode on the main thread
+  world::main.system("player_update").kind(flecs::PreUpdate).no_readonly().iter([](flecs::iter &) { update(); });
 }
 
-void update() {
+static void update() {
 
   // head rotation
 
@@ -48,7 +65,47 @@ void update() {
   const HMM_Quat vertical_rotation = HMM_QFromAxisAngle_LH(HMM_V3(1, 0, 0), player.head_angles.Y);
   const HMM_Quat horizontal_rotation = HMM_QFromAxisAngle_LH(HMM_V3(0, 1, 0), player.head_angles.X);
 
-  player_head.get_mut<comps::Transform>()->rotation = horizontal_rotation * vertical_rotation;
+  comps::LocalTransform &head_local = *player_head.get_mut<comps::LocalTransform>();
+
+  head_local.rotation = horizontal_rotation * vertical_rotation;
+  head_local.dirty = true;
+
+  // target picking
+
+  const HMM_Mat4 &head_world = player_head.get<comps::WorldMatrix>()->matrix;
+
+  const spatial::Ray ray = {
+      .origin = head_world.Columns[3].XYZ,
+      .direction = HMM_NormV3(head_world.Columns[2].XYZ * -1.0f),
+      .max_distance = target_distance,
+  };
+
+  f32 closest_distance = ray.max_distance;
+  u64 target = 0;
+
+  world::main.spatial.query_ray(ray, [&](const u64 user, [[maybe_unused]] const f32 distance) {
+    const flecs::entity entity(world::main, user);
+
+    const comps::WorldMatrix *world = entity.get<comps::WorldMatrix>();
+    const comps::Mesh *mesh = entity.get<comps::Mesh>();
+
+    f32 hit_distance;
+
+    if (world && mesh &&
+        spatial::intersect_ray(ray, spatial::transform_bounds(mesh->bounds, world->matrix), hit_distance) &&
+        hit_distance < closest_distance) {
+      closest_distance = hit_distance;
+      target = user;
+    }
+
+    return closest_distance;
+  });
+
+  if (target != player.target) {
+    LOG_DEBUG("player target: %llu", static_cast<unsigned long long>(target))
+  }
+
+  player.target = target;
 
   // root movement
 
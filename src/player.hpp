@@ -2,8 +2,7 @@
 
 namespace player {
 
+// registers the PreUpdate player system
 void init();
 
-void update();
-
 } // namespace player
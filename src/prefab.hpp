@@ -6,7 +6,10 @@ namespace assets {
 
 struct Prefab {
   struct Node {
-    comps::Transform transform;
+    comps::LocalTransform transform;
+
+    // pre-order like the cooked nodes, -1 for nodes directly below the instance root
+    i32 parent = -1;
 
     bool has_mesh = false;
     comps::Mesh mesh;
@@ -0,0 +1,130 @@
+#include "profile.hpp"
+#include "engine.hpp"
+#include "thirdparty/sokol/sokol_time.h"
+#include <cstring>
+#include <limits>
+
+namespace profile {
+
+struct Section {
+  const c8 *name;
+
+  u64 frame_ticks;
+  u64 total_ticks;
+  u64 min_ticks;
+  u64 max_ticks;
+};
+
+constexpr usize max_sections = 32;
+
+Section sections[max_sections];
+usize section_count = 0;
+
+// index of the running section, -1 outside of a frame
+i32 current_section = -1;
+
+u64 frame_start = 0;
+u64 section_start = 0;
+
+u32 frame_count = 0;
+u64 frame_total_ticks = 0;
+u64 frame_min_ticks = std::numeric_limits<u64>::max();
+u64 frame_max_ticks = 0;
+
+static i32 find_or_add(const c8 *name) {
+  for (usize i_section = 0; i_section < section_count; i_section++) {
+    if (sections[i_section].name == name || strcmp(sections[i_section].name, name) == 0) {
+      return static_cast<i32>(i_section);
+    }
+  }
+
+  LOG_ASSERT(section_count < max_sections);
+
+  sections[section_count] = Section{
+      .name = name,
+      .frame_ticks = 0,
+      .total_ticks = 0,
+      .min_ticks = std::numeric_limits<u64>::max(),
+      .max_ticks = 0,
+  };
+
+  return static_cast<i32>(section_count++);
+}
+
+static void close_section(const u64 now) {
+  if (current_section >= 0) {
+    sections[current_section].frame_ticks += stm_diff(now, section_start);
+  }
+
+  section_start = now;
+}
+
+void begin_frame() {
+  frame_start = stm_now();
+  section_start = frame_start;
+  current_section = -1;
+}
+
+void mark(const c8 *name) {
+  close_section(stm_now());
+
+  current_section = find_or_add(name);
+}
+
+void end_frame() {
+  const u64 now = stm_now();
+
+  close_section(now);
+  current_section = -1;
+
+  // sections that didn't run this frame still count, so their average is per frame
+  for (usize i_section = 0; i_section < section_count; i_section++) {
+    Section &section = sections[i_section];
+
+    section.total_ticks += section.frame_ticks;
+    section.min_ticks = HMM_MIN(section.min_ticks, section.frame_ticks);
+    section.max_ticks = HMM_MAX(section.max_ticks, section.frame_ticks);
+    section.frame_ticks = 0;
+  }
+
+  const u64 frame_ticks = stm_diff(now, frame_start);
+
+  frame_count++;
+  frame_total_ticks += frame_ticks;
+  frame_min_ticks = HMM_MIN(frame_min_ticks, frame_ticks);
+  frame_max_ticks = HMM_MAX(frame_max_ticks, frame_ticks);
+}
+
+void report() {
+  if (frame_count == 0) {
+    LOG_INFO("profile: no frames")
+    return;
+  }
+
+  const f64 frame_avg_ms = stm_ms(frame_total_ticks) / frame_count;
+
+  LOG_INFO("profile: %u frames", frame_count)
+  LOG_INFO("  %-16s %10s %10s %10s %7s", "section", "avg ms", "min ms", "max ms", "share")
+
+  for (usize i_section = 0; i_section < section_count; i_section++) {
+    const Section &section = sections[i_section];
+    const f64 avg_ms = stm_ms(section.total_ticks) / frame_count;
+
+    LOG_INFO("  %-16s %10.3f %10.3f %10.3f %6.1f%%", section.name, avg_ms, stm_ms(section.min_ticks),
+             stm_ms(section.max_ticks), frame_avg_ms > 0.0 ? avg_ms / frame_avg_ms * 100.0 : 0.0)
+  }
+
+  LOG_INFO("  %-16s %10.3f %10.3f %10.3f", "frame", frame_avg_ms, stm_ms(frame_min_ticks), stm_ms(frame_max_ticks))
+}
+
+void reset() {
+  section_count = 0;
+  current_section = -1;
+
+  frame_count = 0;
+  frame_total_ticks = 0;
+  frame_min_ticks = std::numeric_limits<u64>::max();
+  frame_max_ticks = 0;
+}
+
+} // namespace profile
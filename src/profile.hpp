@@ -0,0 +1,22 @@
+#pragma once
+
+#include "types.hpp"
+
+namespace profile {
+
+// wall clock sections of the main thread, a section lasts until the next mark or the end of the frame and a
+// section marked several times per frame accumulates
+
+void begin_frame();
+
+// name has to outlive the profile, usually a string literal
+void mark(const c8 *name);
+
+void end_frame();
+
+// logs avg, min and max per section over all frames since the last reset
+void report();
+
+void reset();
+
+} // namespace profile
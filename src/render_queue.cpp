@@ -0,0 +1,107 @@
+#include "render_queue.hpp"
+#include <cstring>
+#include <utility>
+
+namespace renderer {
+
+u64 make_sort_key(const sg_pipeline pipeline, const comps::MeshBuffer &meshbuffer, const comps::Mesh &mesh,
+                  const f32 depth) {
+  constexpr u64 depth_max = (1ull << sort_key_depth_bits) - 1;
+
+  const f32 depth_normalized = HMM_Clamp(0.0f, depth / sort_key_depth_range, 1.0f);
+
+  const u64 pipeline_bits = pipeline.id & ((1ull << sort_key_pipeline_bits) - 1);
+  const u64 meshbuffer_bits = meshbuffer.bindings.vertex_buffers[0].id & ((1ull << sort_key_meshbuffer_bits) - 1);
+  const u64 mesh_bits = mesh.base_element & ((1ull << sort_key_mesh_bits) - 1);
+  const u64 depth_bits = static_cast<u64>(depth_normalized * depth_max);
+
+  return (pipeline_bits << (sort_key_meshbuffer_bits + sort_key_mesh_bits + sort_key_depth_bits)) |
+         (meshbuffer_bits << (sort_key_mesh_bits + sort_key_depth_bits)) | (mesh_bits << sort_key_depth_bits) |
+         depth_bits;
+}
+
+void RenderQueue::clear() {
+  items.resize(0);
+  worlds.resize(0);
+}
+
+void RenderQueue::push(const sg_pipeline pipeline, const comps::MeshBuffer &meshbuffer, const comps::Mesh &mesh,
+                       const HMM_Mat4 &world, const f32 depth) {
+  const u32 instance = static_cast<u32>(worlds.size());
+
+  worlds.emplace_back(HMM_Mat4(world));
+
+  items.emplace_back(DrawItem{
+      .key = make_sort_key(pipeline, meshbuffer, mesh, depth),
+      .pipeline = pipeline,
+      .meshbuffer = &meshbuffer,
+      .mesh = mesh,
+      .instance = instance,
+  });
+}
+
+void RenderQueue::sort() {
+  const usize item_count = items.size();
+
+  if (item_count < 2) {
+    return;
+  }
+
+  _sort_scratch.resize(item_count);
+
+  // lsd radix sort, 8 bits per pass
+
+  constexpr usize radix_bits = 8;
+  constexpr usize radix_size = 1 << radix_bits;
+  constexpr usize pass_count = sizeof(u64) * 8 / radix_bits;
+
+  usize histograms[pass_count][radix_size] = {};
+
+  for (usize i_item = 0; i_item < item_count; i_item++) {
+    const u64 key = items[i_item].key;
+
+    for (usize i_pass = 0; i_pass < pass_count; i_pass++) {
+      histograms[i_pass][(key >> (i_pass * radix_bits)) & (radix_size - 1)]++;
+    }
+  }
+
+  DrawItem *src = items.data();
+  DrawItem *dst = _sort_scratch.data();
+
+  for (usize i_pass = 0; i_pass < pass_count; i_pass++) {
+    usize *histogram = histograms[i_pass];
+
+    // all keys share this digit
+    if (histogram[(src[0].key >> (i_pass * radix_bits)) & (radix_size - 1)] == item_count) {
+      continue;
+    }
+
+    usize offset = 0;
+
+    for (usize i_bucket = 0; i_bucket < radix_size; i_bucket++) {
+      const usize count = histogram[i_bucket];
+      histogram[i_bucket] = offset;
+      offset += count;
+    }
+
+    for (usize i_item = 0; i_item < item_count; i_item++) {
+      const usize digit = (src[i_item].key >> (i_pass * radix_bits)) & (radix_size - 1);
+
+      dst[histogram[digit]++] = src[i_item];
+    }
+
+    std::swap(src, dst);
+  }
+
+  if (src != items.data()) {
+    memcpy(items.data(), src, item_count * sizeof(DrawItem));
+  }
+}
+
+void RenderQueue::release() {
+  items.release();
+  worlds.release();
+  _sort_scratch.release();
+}
+
+} // namespace renderer
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "components.hpp"
+
+namespace renderer {
+
+// sort key layout, from most to least significant bits:
+// pipeline (8) | meshbuffer (16) | mesh (28) | depth bucket (12)
+
+constexpr u32 sort_key_depth_bits = 12;
+constexpr u32 sort_key_mesh_bits = 28;
+constexpr u32 sort_key_meshbuffer_bits = 16;
+constexpr u32 sort_key_pipeline_bits = 8;
+
+constexpr f32 sort_key_depth_range = 1000.0f;
+
+[[nodiscard]] u64 make_sort_key(const sg_pipeline pipeline, const comps::MeshBuffer &meshbuffer,
+                                const comps::Mesh &mesh, const f32 depth);
+
+// key without the depth bucket, equal for items that can share a draw call
+[[nodiscard]] constexpr u64 sort_key_batch(const u64 key) { return key >> sort_key_depth_bits; }
+
+struct DrawItem {
+  u64 key;
+  sg_pipeline pipeline;
+  const comps::MeshBuffer *meshbuffer;
+  comps::Mesh mesh;
+  u32 instance;
+};
+
+struct RenderQueue {
+  utils::DSArray<DrawItem> items;
+  utils::DSArray<HMM_Mat4> worlds;
+
+private:
+  utils::DSArray<DrawItem> _sort_scratch;
+
+public:
+  void clear();
+
+  void push(const sg_pipeline pipeline, const comps::MeshBuffer &meshbuffer, const comps::Mesh &mesh,
+            const HMM_Mat4 &world, const f32 depth);
+
+  void sort();
+
+  void release();
+};
+
+} // namespace renderer
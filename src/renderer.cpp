@@ -1,20 +1,96 @@
 #include "renderer.hpp"
 #include "thirdparty/HandmadeMath/HandmadeMath.h"
+#include "thirdparty/sokol/sokol_log.h"
+#ifndef LBTL_HEADLESS
 #include "thirdparty/sokol/sokol_app.h"
 #include "thirdparty/sokol/sokol_glue.h"
-#include "thirdparty/sokol/sokol_log.h"
+#endif
 #include "thirdparty/sokol/util/sokol_color.h"
 
+#include "culling.hpp"
+#include "render_queue.hpp"
 #include "shader/unlit.glsl.h"
 #include "world.hpp"
+#include <cstring>
+#include <limits>
 
 namespace renderer {
 
-sg_pipeline unlit_pipeline = {};
+constexpr usize vertex_format_count = 2;
+constexpr usize index_format_count = 2;
+
+// unlit variants by [vertex format][index format][instanced]
+sg_pipeline unlit_pipelines[vertex_format_count][index_format_count][2] = {};
+
+bool instancing = true;
+Stats stats = {};
+
+RenderQueue queue;
+HMM_Mat4 view_projection = HMM_M4D(1.0f);
+
+// culling
+
+struct CullCandidate {
+  const comps::WorldMatrix *world;
+  const comps::MeshBuffer *meshbuffer;
+  const comps::Mesh *mesh;
+  i32 proxy;
+};
+
+culling::Spheres cull_spheres;
+utils::DSArray<u8> cull_visible;
+
+// lod selection
+
+// a lod is used while its error covers at most this many pixels
+constexpr f32 lod_pixel_error = 1.0f;
+
+// switching to a coarser lod needs this much headroom below the threshold, so meshes don't flicker at the boundary
+constexpr f32 lod_hysteresis = 0.75f;
+
+// lod picked last frame by spatial proxy id, a reused id only changes where the search starts
+utils::DSArray<u8> proxy_lods;
+
+// instancing
+
+utils::DSArray<HMM_Mat4> instance_data;
+
+sg_buffer instance_buffer = {};
+usize instance_capacity = 0;
+
+// every unlit variant shares the attribute slots of vs and vs_instanced
+static sg_pipeline make_unlit_pipeline(const sg_shader shader, const comps::MeshBuffer::VertexFormat format,
+                                       const comps::MeshBuffer::IndexFormat index_format, const bool instanced) {
+  sg_pipeline_desc desc = {};
+  desc.shader = shader;
+  desc.index_type = index_format == comps::MeshBuffer::IndexFormat::U32 ? SG_INDEXTYPE_UINT32 : SG_INDEXTYPE_UINT16;
+  desc.label = "unlit_pipeline";
+  desc.depth = {.compare = SG_COMPAREFUNC_LESS_EQUAL, .write_enabled = true};
+
+  if (format == comps::MeshBuffer::VertexFormat::QUANTIZED) {
+    desc.layout.attrs[ATTR_vs_position].format = SG_VERTEXFORMAT_SHORT4N;
+    desc.layout.attrs[ATTR_vs_normal0].format = SG_VERTEXFORMAT_SHORT2N;
+    desc.layout.attrs[ATTR_vs_uv0].format = SG_VERTEXFORMAT_HALF2;
+  } else {
+    desc.layout.attrs[ATTR_vs_position].format = SG_VERTEXFORMAT_FLOAT3;
+    desc.layout.attrs[ATTR_vs_normal0].format = SG_VERTEXFORMAT_FLOAT3;
+    desc.layout.attrs[ATTR_vs_uv0].format = SG_VERTEXFORMAT_FLOAT2;
+  }
+
+  if (instanced) {
+    desc.layout.buffers[1].step_func = SG_VERTEXSTEP_PER_INSTANCE;
+    desc.layout.attrs[ATTR_vs_instanced_model0] = {.buffer_index = 1, .format = SG_VERTEXFORMAT_FLOAT4};
+    desc.layout.attrs[ATTR_vs_instanced_model1] = {.buffer_index = 1, .format = SG_VERTEXFORMAT_FLOAT4};
+    desc.layout.attrs[ATTR_vs_instanced_model2] = {.buffer_index = 1, .format = SG_VERTEXFORMAT_FLOAT4};
+    desc.layout.attrs[ATTR_vs_instanced_model3] = {.buffer_index = 1, .format = SG_VERTEXFORMAT_FLOAT4};
+  }
+
+  return sg_make_pipeline(desc);
+}
 
 void init() {
   const static auto my_alloc = [](size_t size, [[maybe_unused]] void *user_data) -> void * {
-    return utils::aligned_alloc_16(size);
+    return utils::aligned_alloc_16(size, utils::MemoryTag::RENDERER);
   };
 
   const static auto my_free = [](void *ptr, [[maybe_unused]] void *user_data) { utils::aligned_free_16(ptr); };
@@ -29,30 +105,58 @@ void init() {
           {
               .func = slog_func,
           },
+#ifndef LBTL_HEADLESS
       .context = sapp_sgcontext(),
+#endif
   });
 
   if (!sg_isvalid()) {
     LOG_PANIC("!sg_isvalid()")
   }
 
-  sg_shader unlit_shader = sg_make_shader(unlit_shader_desc(sg_query_backend()));
+#ifdef LBTL_HEADLESS
+  // shaders are only generated for gl, the dummy backend accepts any valid description
+  const sg_backend shader_backend = SG_BACKEND_GLCORE33;
+#else
+  const sg_backend shader_backend = sg_query_backend();
+#endif
 
-  sg_pipeline_desc unlit_pipeline_desc = {};
-  unlit_pipeline_desc.shader = unlit_shader;
-  unlit_pipeline_desc.index_type = SG_INDEXTYPE_UINT16;
-  unlit_pipeline_desc.label = "unlit_pipeline";
-  unlit_pipeline_desc.layout.attrs[ATTR_vs_position].format = SG_VERTEXFORMAT_FLOAT3;
-  unlit_pipeline_desc.layout.attrs[ATTR_vs_normal0].format = SG_VERTEXFORMAT_FLOAT3;
-  unlit_pipeline_desc.layout.attrs[ATTR_vs_uv0].format = SG_VERTEXFORMAT_FLOAT2;
-  unlit_pipeline_desc.depth = {.compare = SG_COMPAREFUNC_LESS_EQUAL, .write_enabled = true},
+  // [vertex format][instanced]
+  const sg_shader unlit_shaders[vertex_format_count][2] = {
+      {
+          sg_make_shader(unlit_shader_desc(shader_backend)),
+          sg_make_shader(unlit_instanced_shader_desc(shader_backend)),
+      },
+      {
+          sg_make_shader(unlit_quantized_shader_desc(shader_backend)),
+          sg_make_shader(unlit_quantized_instanced_shader_desc(shader_backend)),
+      },
+  };
 
-  unlit_pipeline = sg_make_pipeline(unlit_pipeline_desc);
+  for (usize i_vertex_format = 0; i_vertex_format < vertex_format_count; i_vertex_format++) {
+    for (usize i_index_format = 0; i_index_format < index_format_count; i_index_format++) {
+      for (usize i_instanced = 0; i_instanced < 2; i_instanced++) {
+        unlit_pipelines[i_vertex_format][i_index_format][i_instanced] =
+            make_unlit_pipeline(unlit_shaders[i_vertex_format][i_instanced],
+                                static_cast<comps::MeshBuffer::VertexFormat>(i_vertex_format),
+                                static_cast<comps::MeshBuffer::IndexFormat>(i_index_format), i_instanced == 1);
+      }
+    }
+  }
+
+  // sokol_gfx calls have to stay on the main thread, so neither system is multi threaded
+  world::main.system("renderer_collect").kind(flecs::PreStore).iter([](flecs::iter &) { collect(); });
+  world::main.system("renderer_draw").kind(flecs::OnStore).iter([](flecs::iter &) { draw(); });
 }
 
-comps::MeshBuffer upload_meshbuffer(const sg_range vertices, const sg_range indices) {
+comps::MeshBuffer upload_meshbuffer(const sg_range vertices, const sg_range indices,
+                                    const comps::MeshBuffer::VertexFormat vertex_format,
+                                    const comps::MeshBuffer::IndexFormat index_format) {
   comps::MeshBuffer mesh = {};
 
+  mesh.vertex_format = vertex_format;
+  mesh.index_format = index_format;
+
   mesh.bindings.vertex_buffers[0] = sg_make_buffer(sg_buffer_desc{.data = vertices});
 
   mesh.bindings.index_buffer = sg_make_buffer(sg_buffer_desc{
@@ -68,39 +172,351 @@ void release_meshbuffer(comps::MeshBuffer &meshbuffer) {
   sg_destroy_buffer(meshbuffer.bindings.vertex_buffers[0]);
 }
 
-void draw() {
-  sg_pass_action pass_action = {};
-  pass_action.colors[0].clear_value = SG_GRAY;
+void reserve_instance_buffer(const usize instance_count) {
+  if (instance_count <= instance_capacity) {
+    return;
+  }
+
+  if (instance_capacity == 0) {
+    instance_capacity = 256;
+  }
+
+  while (instance_capacity < instance_count) {
+    instance_capacity *= 2;
+  }
+
+  sg_destroy_buffer(instance_buffer);
+
+  instance_buffer = sg_make_buffer(sg_buffer_desc{
+      .size = instance_capacity * sizeof(HMM_Mat4),
+      .usage = SG_USAGE_STREAM,
+      .label = "instance_buffer",
+  });
+}
+
+static sg_pipeline get_pipeline(const comps::MeshBuffer &meshbuffer) {
+  return unlit_pipelines[static_cast<usize>(meshbuffer.vertex_format)][static_cast<usize>(meshbuffer.index_format)]
+                        [instancing ? 1 : 0];
+}
+
+static f32 get_max_scale(const HMM_Mat4 &world) {
+  return HMM_MAX(HMM_LenV3(world.Columns[0].XYZ),
+                 HMM_MAX(HMM_LenV3(world.Columns[1].XYZ), HMM_LenV3(world.Columns[2].XYZ)));
+}
 
-  sg_begin_default_pass(&pass_action, sapp_width(), sapp_height());
+// pixels_per_unit is the screen size of one world unit at a depth of one
+static u32 select_lod(const CullCandidate &candidate, const f32 depth, const f32 pixels_per_unit) {
+  const comps::Mesh &mesh = *candidate.mesh;
+
+  if (mesh.lod_count == 0 || candidate.proxy < 0) {
+    return 0;
+  }
+
+  const f32 pixels_per_model_unit =
+      pixels_per_unit * get_max_scale(candidate.world->matrix) / HMM_MAX(depth, std::numeric_limits<f32>::epsilon());
+
+  const auto get_pixel_error = [&](const u32 lod) {
+    return lod == 0 ? 0.0f : mesh.lods[lod - 1].error * pixels_per_model_unit;
+  };
+
+  const usize proxy = static_cast<usize>(candidate.proxy);
+
+  if (proxy >= proxy_lods.size()) {
+    const usize old_size = proxy_lods.size();
+
+    proxy_lods.resize(proxy + 1);
+    memset(&proxy_lods[old_size], 0, proxy + 1 - old_size);
+  }
+
+  u32 lod = HMM_MIN(static_cast<u32>(proxy_lods[proxy]), mesh.lod_count);
+
+  while (lod > 0 && get_pixel_error(lod) > lod_pixel_error) {
+    lod--;
+  }
+
+  while (lod < mesh.lod_count && get_pixel_error(lod + 1) <= lod_pixel_error * lod_hysteresis) {
+    lod++;
+  }
 
-  sg_apply_pipeline(unlit_pipeline);
+  proxy_lods[proxy] = static_cast<u8>(lod);
 
-  const HMM_Mat4 view = HMM_InvGeneral(world::main.camera.get<comps::Transform>()->world);
+  return lod;
+}
+
+// the quantized shaders rebuild positions from the mesh bounds they were quantized against
+static HMM_Vec4 get_position_offset(const comps::Mesh &mesh) { return HMM_V4V(mesh.bounds.center, 0.0f); }
+
+static HMM_Vec4 get_position_scale(const comps::Mesh &mesh) { return HMM_V4V(mesh.bounds.extents, 0.0f); }
+
+void collect() {
+  const utils::MemoryTagScope tag_scope(utils::MemoryTag::RENDERER);
+
+  const HMM_Mat4 view = HMM_InvGeneral(world::main.camera.get<comps::WorldMatrix>()->matrix);
   const HMM_Mat4 proj = world::main.camera.get<comps::Camera>()->projection;
 
-  const HMM_Mat4 vp = proj * view;
+  view_projection = proj * view;
+
+  stats = {};
+
+  // broad phase, leaves fully inside the frustum skip the sphere test
+
+  const culling::Frustum frustum = culling::make_frustum(view_projection);
+
+  // only live for this frame
+  utils::ArenaArray<CullCandidate> cull_candidates(utils::get_frame_arena());
+  utils::ArenaArray<CullCandidate> cull_inside(utils::get_frame_arena());
+
+  cull_spheres.clear();
+
+  world::main.spatial.query_frustum(frustum, [&](const u64 user, const bool inside) {
+    const flecs::entity entity(world::main, user);
+
+    const comps::WorldMatrix *world_matrix = entity.get<comps::WorldMatrix>();
+    const comps::MeshBuffer *meshbuffer = entity.get<comps::MeshBuffer>();
+    const comps::Mesh *mesh = entity.get<comps::Mesh>();
+    const comps::SpatialProxy *proxy = entity.get<comps::SpatialProxy>();
+
+    if (world_matrix == nullptr || meshbuffer == nullptr || mesh == nullptr) {
+      return true;
+    }
+
+    const CullCandidate candidate = {
+        .world = world_matrix,
+        .meshbuffer = meshbuffer,
+        .mesh = mesh,
+        .proxy = proxy != nullptr ? proxy->id : -1,
+    };
+
+    if (inside) {
+      cull_inside.emplace_back(CullCandidate(candidate));
+      return true;
+    }
+
+    const HMM_Mat4 &world = world_matrix->matrix;
+
+    const HMM_Vec3 center = (world * HMM_V4V(mesh->bounds.center, 1.0f)).XYZ;
+
+    cull_spheres.push(center, mesh->bounds.radius * get_max_scale(world));
+    cull_candidates.emplace_back(CullCandidate(candidate));
 
-  world::main.query_transform_meshbuffer_mesh.each(
-      [&](const comps::Transform &transform, const comps::MeshBuffer &meshbuffer, const comps::Mesh &mesh) {
-        const HMM_Mat4 mvp = vp * transform.world;
+    return true;
+  });
+
+  // narrow phase
+
+  const usize visible_count = culling::cull_spheres(frustum, cull_spheres, cull_visible) + cull_inside.size();
+
+  stats.visible = static_cast<u32>(visible_count);
+  stats.culled = static_cast<u32>(world::main.spatial.leaf_count() - visible_count);
+
+  // queue visible meshes, each at the coarsest lod whose error stays below a pixel
+
+  const f32 pixels_per_unit = proj.Elements[1][1] * 0.5f * get_width_height().Y;
+
+  const auto push_candidate = [&](const CullCandidate &candidate) {
+    const HMM_Mat4 &world = candidate.world->matrix;
+
+    const f32 depth = (view_projection * world.Columns[3]).W;
+    const u32 lod = select_lod(candidate, depth, pixels_per_unit);
+
+    comps::Mesh mesh = *candidate.mesh;
+
+    if (lod > 0) {
+      mesh.base_element = mesh.lods[lod - 1].base_element;
+      mesh.index_count = mesh.lods[lod - 1].index_count;
+
+      stats.simplified++;
+    }
+
+    queue.push(get_pipeline(*candidate.meshbuffer), *candidate.meshbuffer, mesh, world, depth);
+  };
+
+  queue.clear();
+
+  for (usize i_candidate = 0; i_candidate < cull_inside.size(); i_candidate++) {
+    push_candidate(cull_inside[i_candidate]);
+  }
+
+  for (usize i_candidate = 0; i_candidate < cull_candidates.size(); i_candidate++) {
+    if (cull_visible[i_candidate]) {
+      push_candidate(cull_candidates[i_candidate]);
+    }
+  }
+
+  queue.sort();
+}
+
+void draw_single() {
+  sg_pipeline current_pipeline = {};
+  const comps::MeshBuffer *current_meshbuffer = nullptr;
+
+  for (usize i_item = 0; i_item < queue.items.size(); i_item++) {
+    const DrawItem &item = queue.items[i_item];
+
+    if (item.pipeline.id != current_pipeline.id) {
+      current_pipeline = item.pipeline;
+      current_meshbuffer = nullptr;
+
+      sg_apply_pipeline(current_pipeline);
+      stats.pipeline_changes++;
+    }
+
+    if (current_meshbuffer == nullptr ||
+        item.meshbuffer->bindings.vertex_buffers[0].id != current_meshbuffer->bindings.vertex_buffers[0].id ||
+        item.meshbuffer->bindings.index_buffer.id != current_meshbuffer->bindings.index_buffer.id) {
+      current_meshbuffer = item.meshbuffer;
+
+      sg_apply_bindings(&current_meshbuffer->bindings);
+      stats.binding_changes++;
+    }
+
+    const HMM_Mat4 mvp = view_projection * queue.worlds[item.instance];
+
+    if (current_meshbuffer->vertex_format == comps::MeshBuffer::VertexFormat::QUANTIZED) {
+      const vs_quantized_params_t vs_quantized_params = {
+          .mvp = mvp,
+          .position_offset = get_position_offset(item.mesh),
+          .position_scale = get_position_scale(item.mesh),
+      };
+
+      sg_apply_uniforms(SG_SHADERSTAGE_VS, SLOT_vs_quantized_params, SG_RANGE(vs_quantized_params));
+    } else {
+      const vs_params_t vs_params = {
+          .mvp = mvp,
+      };
+
+      sg_apply_uniforms(SG_SHADERSTAGE_VS, SLOT_vs_params, SG_RANGE(vs_params));
+    }
+
+    sg_draw(item.mesh.base_element, item.mesh.index_count, 1);
+
+    stats.draw_calls++;
+    stats.instances++;
+  }
+}
+
+void draw_instanced() {
+  const usize item_count = queue.items.size();
+
+  // stream world matrices in queue order, so each batch is a contiguous range
+
+  reserve_instance_buffer(item_count);
 
-        const vs_params_t vs_params = {
-            .mvp = mvp,
-        };
+  instance_data.resize(item_count);
 
-        sg_apply_bindings(&meshbuffer.bindings);
-        sg_apply_uniforms(SG_SHADERSTAGE_VS, SLOT_vs_params, SG_RANGE(vs_params));
+  for (usize i_item = 0; i_item < item_count; i_item++) {
+    instance_data[i_item] = queue.worlds[queue.items[i_item].instance];
+  }
+
+  sg_update_buffer(instance_buffer, sg_range{.ptr = instance_data.data(), .size = item_count * sizeof(HMM_Mat4)});
+
+  // one draw per batch
+
+  sg_pipeline current_pipeline = {};
+
+  const vs_instanced_params_t vs_instanced_params = {
+      .vp = view_projection,
+  };
+
+  usize batch_begin = 0;
+
+  while (batch_begin < item_count) {
+    const DrawItem &batch_item = queue.items[batch_begin];
+
+    usize batch_end = batch_begin + 1;
+
+    while (batch_end < item_count && sort_key_batch(queue.items[batch_end].key) == sort_key_batch(batch_item.key) &&
+           queue.items[batch_end].mesh.index_count == batch_item.mesh.index_count) {
+      batch_end++;
+    }
+
+    const usize batch_size = batch_end - batch_begin;
+
+    const bool quantized = batch_item.meshbuffer->vertex_format == comps::MeshBuffer::VertexFormat::QUANTIZED;
+
+    if (batch_item.pipeline.id != current_pipeline.id) {
+      current_pipeline = batch_item.pipeline;
+
+      sg_apply_pipeline(current_pipeline);
+      stats.pipeline_changes++;
+
+      if (!quantized) {
+        sg_apply_uniforms(SG_SHADERSTAGE_VS, SLOT_vs_instanced_params, SG_RANGE(vs_instanced_params));
+      }
+    }
+
+    // a batch is a single mesh, so its bounds go out with every batch
+    if (quantized) {
+      const vs_quantized_instanced_params_t vs_quantized_instanced_params = {
+          .vp = view_projection,
+          .position_offset = get_position_offset(batch_item.mesh),
+          .position_scale = get_position_scale(batch_item.mesh),
+      };
+
+      sg_apply_uniforms(SG_SHADERSTAGE_VS, SLOT_vs_quantized_instanced_params,
+                        SG_RANGE(vs_quantized_instanced_params));
+    }
+
+    // the instance buffer offset changes per batch, so bindings are always applied
+    sg_bindings bindings = batch_item.meshbuffer->bindings;
+    bindings.vertex_buffers[1] = instance_buffer;
+    bindings.vertex_buffer_offsets[1] = static_cast<i32>(batch_begin * sizeof(HMM_Mat4));
+
+    sg_apply_bindings(&bindings);
+    stats.binding_changes++;
 
-        sg_draw(mesh.base_vertex, mesh.index_count, 1);
-      });
+    sg_draw(batch_item.mesh.base_element, batch_item.mesh.index_count, static_cast<i32>(batch_size));
+
+    stats.draw_calls++;
+    stats.instances += static_cast<u32>(batch_size);
+
+    batch_begin = batch_end;
+  }
+}
+
+void draw() {
+  const utils::MemoryTagScope tag_scope(utils::MemoryTag::RENDERER);
+
+  sg_pass_action pass_action = {};
+  pass_action.colors[0].clear_value = SG_GRAY;
+
+  const HMM_Vec2 width_height = get_width_height();
+
+  sg_begin_default_pass(&pass_action, static_cast<i32>(width_height.X), static_cast<i32>(width_height.Y));
+
+  if (queue.items.size() > 0) {
+    if (instancing) {
+      draw_instanced();
+    } else {
+      draw_single();
+    }
+  }
 
   sg_end_pass();
   sg_commit();
 }
 
-void finish() { sg_shutdown(); }
+void finish() {
+  queue.release();
+  instance_data.release();
+  cull_spheres.release();
+  cull_visible.release();
+  proxy_lods.release();
+
+  sg_shutdown();
+}
+
+void set_instancing(const bool enabled) { instancing = enabled; }
+
+[[nodiscard]] bool get_instancing() { return instancing; }
+
+[[nodiscard]] const Stats &get_stats() { return stats; }
 
+#ifdef LBTL_HEADLESS
+// same as the default window
+[[nodiscard]] HMM_Vec2 get_width_height() { return HMM_V2(1200.0f, 800.0f); }
+#else
 [[nodiscard]] HMM_Vec2 get_width_height() { return HMM_V2(sapp_widthf(), sapp_heightf()); }
+#endif
 
 } // namespace renderer
@@ -4,16 +4,42 @@
 
 namespace renderer {
 
+struct Stats {
+  u32 draw_calls;
+  u32 instances;
+  u32 pipeline_changes;
+  u32 binding_changes;
+  u32 visible;
+  u32 culled;
+
+  // visible meshes drawn at one of their simplified lods
+  u32 simplified;
+};
+
+// registers the PreStore collect and OnStore draw systems
 void init();
 
-comps::MeshBuffer upload_meshbuffer(const sg_range vertices, const sg_range indices);
+// vertices are laid out as Vertex or QuantizedVertex and indices as u16 or u32 depending on the formats
+comps::MeshBuffer upload_meshbuffer(const sg_range vertices, const sg_range indices,
+                                    const comps::MeshBuffer::VertexFormat vertex_format,
+                                    const comps::MeshBuffer::IndexFormat index_format);
 
 void release_meshbuffer(comps::MeshBuffer &meshbuffer);
 
+// culls and queues the visible meshes
+void collect();
+
+// draws the queue built by collect
 void draw();
 
 void finish();
 
+void set_instancing(const bool enabled);
+
+[[nodiscard]] bool get_instancing();
+
+[[nodiscard]] const Stats &get_stats();
+
 [[nodiscard]] HMM_Vec2 get_width_height();
 
 } // namespace renderer
\ No newline at end of file
@@ -1,4 +1,5 @@
 @ctype mat4 HMM_Mat4
+@ctype vec4 HMM_Vec4
 
 @vs vs
 uniform vs_params {
@@ -19,6 +20,97 @@ void main() {
 }
 @end
 
+@vs vs_instanced
+uniform vs_instanced_params {
+    mat4 vp;
+};
+
+in vec3 position;
+in vec3 normal0;
+in vec2 uv0;
+
+in vec4 model0;
+in vec4 model1;
+in vec4 model2;
+in vec4 model3;
+
+out vec3 normal;
+out vec2 uv;
+
+void main() {
+    const mat4 model = mat4(model0, model1, model2, model3);
+
+    gl_Position = vp * model * vec4(position, 1.0);
+    normal = normal0;
+    uv = uv0;
+}
+@end
+
+// quantized vertices, see comps::MeshBuffer::QuantizedVertex
+
+@block dequantize
+vec3 decode_octahedral(vec2 encoded) {
+    vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-normal.z, 0.0);
+    normal.x += normal.x >= 0.0 ? -fold : fold;
+    normal.y += normal.y >= 0.0 ? -fold : fold;
+    return normalize(normal);
+}
+@end
+
+@vs vs_quantized
+uniform vs_quantized_params {
+    mat4 mvp;
+    vec4 position_offset;
+    vec4 position_scale;
+};
+
+in vec4 position;
+in vec2 normal0;
+in vec2 uv0;
+
+out vec3 normal;
+out vec2 uv;
+
+@include_block dequantize
+
+void main() {
+    gl_Position = mvp * vec4(position_offset.xyz + position.xyz * position_scale.xyz, 1.0);
+    normal = decode_octahedral(normal0);
+    uv = uv0;
+}
+@end
+
+@vs vs_quantized_instanced
+uniform vs_quantized_instanced_params {
+    mat4 vp;
+    vec4 position_offset;
+    vec4 position_scale;
+};
+
+in vec4 position;
+in vec2 normal0;
+in vec2 uv0;
+
+in vec4 model0;
+in vec4 model1;
+in vec4 model2;
+in vec4 model3;
+
+out vec3 normal;
+out vec2 uv;
+
+@include_block dequantize
+
+void main() {
+    const mat4 model = mat4(model0, model1, model2, model3);
+
+    gl_Position = vp * model * vec4(position_offset.xyz + position.xyz * position_scale.xyz, 1.0);
+    normal = decode_octahedral(normal0);
+    uv = uv0;
+}
+@end
+
 @fs fs
 
 in vec3 normal;
@@ -32,3 +124,6 @@ void main() {
 @end
 
 @program unlit vs fs
+@program unlit_instanced vs_instanced fs
+@program unlit_quantized vs_quantized fs
+@program unlit_quantized_instanced vs_quantized_instanced fs
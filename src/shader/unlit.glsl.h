@@ -20,10 +20,57 @@
                     Bind slot: SLOT_vs_params = 0
             Fragment shader: fs
 
+        Shader program 'unlit_instanced':
+            Get shader desc: unlit_instanced_shader_desc(sg_query_backend());
+            Vertex shader: vs_instanced
+                Attribute slots:
+                    ATTR_vs_instanced_position = 0
+                    ATTR_vs_instanced_normal0 = 1
+                    ATTR_vs_instanced_uv0 = 2
+                    ATTR_vs_instanced_model0 = 3
+                    ATTR_vs_instanced_model1 = 4
+                    ATTR_vs_instanced_model2 = 5
+                    ATTR_vs_instanced_model3 = 6
+                Uniform block 'vs_instanced_params':
+                    C struct: vs_instanced_params_t
+                    Bind slot: SLOT_vs_instanced_params = 0
+            Fragment shader: fs
+
+        Shader program 'unlit_quantized':
+            Get shader desc: unlit_quantized_shader_desc(sg_query_backend());
+            Vertex shader: vs_quantized
+                Attribute slots:
+                    ATTR_vs_quantized_position = 0
+                    ATTR_vs_quantized_normal0 = 1
+                    ATTR_vs_quantized_uv0 = 2
+                Uniform block 'vs_quantized_params':
+                    C struct: vs_quantized_params_t
+                    Bind slot: SLOT_vs_quantized_params = 0
+            Fragment shader: fs
+
+        Shader program 'unlit_quantized_instanced':
+            Get shader desc: unlit_quantized_instanced_shader_desc(sg_query_backend());
+            Vertex shader: vs_quantized_instanced
+                Attribute slots:
+                    ATTR_vs_quantized_instanced_position = 0
+                    ATTR_vs_quantized_instanced_normal0 = 1
+                    ATTR_vs_quantized_instanced_uv0 = 2
+                    ATTR_vs_quantized_instanced_model0 = 3
+                    ATTR_vs_quantized_instanced_model1 = 4
+                    ATTR_vs_quantized_instanced_model2 = 5
+                    ATTR_vs_quantized_instanced_model3 = 6
+                Uniform block 'vs_quantized_instanced_params':
+                    C struct: vs_quantized_instanced_params_t
+                    Bind slot: SLOT_vs_quantized_instanced_params = 0
+            Fragment shader: fs
+
 
     Shader descriptor structs:
 
         sg_shader unlit = sg_make_shader(unlit_shader_desc(sg_query_backend()));
+        sg_shader unlit_instanced = sg_make_shader(unlit_instanced_shader_desc(sg_query_backend()));
+        sg_shader unlit_quantized = sg_make_shader(unlit_quantized_shader_desc(sg_query_backend()));
+        sg_shader unlit_quantized_instanced = sg_make_shader(unlit_quantized_instanced_shader_desc(sg_query_backend()));
 
     Vertex attribute locations for vertex shader 'vs':
 
@@ -37,6 +84,50 @@
             },
             ...});
 
+    Vertex attribute locations for vertex shader 'vs_instanced':
+
+        sg_pipeline pip = sg_make_pipeline(&(sg_pipeline_desc){
+            .layout = {
+                .attrs = {
+                    [ATTR_vs_instanced_position] = { ... },
+                    [ATTR_vs_instanced_normal0] = { ... },
+                    [ATTR_vs_instanced_uv0] = { ... },
+                    [ATTR_vs_instanced_model0] = { ... },
+                    [ATTR_vs_instanced_model1] = { ... },
+                    [ATTR_vs_instanced_model2] = { ... },
+                    [ATTR_vs_instanced_model3] = { ... },
+                },
+            },
+            ...});
+
+    Vertex attribute locations for vertex shader 'vs_quantized':
+
+        sg_pipeline pip = sg_make_pipeline(&(sg_pipeline_desc){
+            .layout = {
+                .attrs = {
+                    [ATTR_vs_quantized_position] = { ... },
+                    [ATTR_vs_quantized_normal0] = { ... },
+                    [ATTR_vs_quantized_uv0] = { ... },
+                },
+            },
+            ...});
+
+    Vertex attribute locations for vertex shader 'vs_quantized_instanced':
+
+        sg_pipeline pip = sg_make_pipeline(&(sg_pipeline_desc){
+            .layout = {
+                .attrs = {
+                    [ATTR_vs_quantized_instanced_position] = { ... },
+                    [ATTR_vs_quantized_instanced_normal0] = { ... },
+                    [ATTR_vs_quantized_instanced_uv0] = { ... },
+                    [ATTR_vs_quantized_instanced_model0] = { ... },
+                    [ATTR_vs_quantized_instanced_model1] = { ... },
+                    [ATTR_vs_quantized_instanced_model2] = { ... },
+                    [ATTR_vs_quantized_instanced_model3] = { ... },
+                },
+            },
+            ...});
+
 
     Image bind slots, use as index in sg_bindings.vs.images[] or .fs.images[]
 
@@ -51,6 +142,31 @@
         };
         sg_apply_uniforms(SG_SHADERSTAGE_[VS|FS], SLOT_vs_params, &SG_RANGE(vs_params));
 
+    Bind slot and C-struct for uniform block 'vs_instanced_params':
+
+        vs_instanced_params_t vs_instanced_params = {
+            .vp = ...;
+        };
+        sg_apply_uniforms(SG_SHADERSTAGE_[VS|FS], SLOT_vs_instanced_params, &SG_RANGE(vs_instanced_params));
+
+    Bind slot and C-struct for uniform block 'vs_quantized_params':
+
+        vs_quantized_params_t vs_quantized_params = {
+            .mvp = ...;
+            .position_offset = ...;
+            .position_scale = ...;
+        };
+        sg_apply_uniforms(SG_SHADERSTAGE_[VS|FS], SLOT_vs_quantized_params, &SG_RANGE(vs_quantized_params));
+
+    Bind slot and C-struct for uniform block 'vs_quantized_instanced_params':
+
+        vs_quantized_instanced_params_t vs_quantized_instanced_params = {
+            .vp = ...;
+            .position_offset = ...;
+            .position_scale = ...;
+        };
+        sg_apply_uniforms(SG_SHADERSTAGE_[VS|FS], SLOT_vs_quantized_instanced_params, &SG_RANGE(vs_quantized_instanced_params));
+
 */
 #include <stdint.h>
 #include <stdbool.h>
@@ -66,12 +182,51 @@
 #define ATTR_vs_position (0)
 #define ATTR_vs_normal0 (1)
 #define ATTR_vs_uv0 (2)
+#define ATTR_vs_instanced_position (0)
+#define ATTR_vs_instanced_normal0 (1)
+#define ATTR_vs_instanced_uv0 (2)
+#define ATTR_vs_instanced_model0 (3)
+#define ATTR_vs_instanced_model1 (4)
+#define ATTR_vs_instanced_model2 (5)
+#define ATTR_vs_instanced_model3 (6)
+#define ATTR_vs_quantized_position (0)
+#define ATTR_vs_quantized_normal0 (1)
+#define ATTR_vs_quantized_uv0 (2)
+#define ATTR_vs_quantized_instanced_position (0)
+#define ATTR_vs_quantized_instanced_normal0 (1)
+#define ATTR_vs_quantized_instanced_uv0 (2)
+#define ATTR_vs_quantized_instanced_model0 (3)
+#define ATTR_vs_quantized_instanced_model1 (4)
+#define ATTR_vs_quantized_instanced_model2 (5)
+#define ATTR_vs_quantized_instanced_model3 (6)
 #define SLOT_vs_params (0)
+#define SLOT_vs_instanced_params (0)
+#define SLOT_vs_quantized_params (0)
+#define SLOT_vs_quantized_instanced_params (0)
 #pragma pack(push,1)
 SOKOL_SHDC_ALIGN(16) typedef struct vs_params_t {
     HMM_Mat4 mvp;
 } vs_params_t;
 #pragma pack(pop)
+#pragma pack(push,1)
+SOKOL_SHDC_ALIGN(16) typedef struct vs_instanced_params_t {
+    HMM_Mat4 vp;
+} vs_instanced_params_t;
+#pragma pack(pop)
+#pragma pack(push,1)
+SOKOL_SHDC_ALIGN(16) typedef struct vs_quantized_params_t {
+    HMM_Mat4 mvp;
+    HMM_Vec4 position_offset;
+    HMM_Vec4 position_scale;
+} vs_quantized_params_t;
+#pragma pack(pop)
+#pragma pack(push,1)
+SOKOL_SHDC_ALIGN(16) typedef struct vs_quantized_instanced_params_t {
+    HMM_Mat4 vp;
+    HMM_Vec4 position_offset;
+    HMM_Vec4 position_scale;
+} vs_quantized_instanced_params_t;
+#pragma pack(pop)
 /*
     #version 330
     
@@ -117,6 +272,297 @@ static const char vs_source_glsl330[339] = {
 /*
     #version 330
     
+    uniform vec4 vs_instanced_params[4];
+    layout(location = 3) in vec4 model0;
+    layout(location = 4) in vec4 model1;
+    layout(location = 5) in vec4 model2;
+    layout(location = 6) in vec4 model3;
+    layout(location = 0) in vec3 position;
+    out vec3 normal;
+    layout(location = 1) in vec3 normal0;
+    out vec2 uv;
+    layout(location = 2) in vec2 uv0;
+    
+    void main()
+    {
+        gl_Position = (mat4(vs_instanced_params[0], vs_instanced_params[1], vs_instanced_params[2], vs_instanced_params[3]) * mat4(model0, model1, model2, model3)) * vec4(position, 1.0);
+        normal = normal0;
+        uv = uv0;
+    }
+    
+*/
+static const char vs_instanced_source_glsl330[578] = {
+    0x23,0x76,0x65,0x72,0x73,0x69,0x6f,0x6e,0x20,0x33,0x33,0x30,0x0a,0x0a,0x75,0x6e,
+    0x69,0x66,0x6f,0x72,0x6d,0x20,0x76,0x65,0x63,0x34,0x20,0x76,0x73,0x5f,0x69,0x6e,
+    0x73,0x74,0x61,0x6e,0x63,0x65,0x64,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x34,
+    0x5d,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,
+    0x6f,0x6e,0x20,0x3d,0x20,0x33,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x34,0x20,
+    0x6d,0x6f,0x64,0x65,0x6c,0x30,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,
+    0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x34,0x29,0x20,0x69,0x6e,0x20,
+    0x76,0x65,0x63,0x34,0x20,0x6d,0x6f,0x64,0x65,0x6c,0x31,0x3b,0x0a,0x6c,0x61,0x79,
+    0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x35,
+    0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x34,0x20,0x6d,0x6f,0x64,0x65,0x6c,0x32,
+    0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,
+    0x6e,0x20,0x3d,0x20,0x36,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x34,0x20,0x6d,
+    0x6f,0x64,0x65,0x6c,0x33,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,
+    0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x30,0x29,0x20,0x69,0x6e,0x20,0x76,
+    0x65,0x63,0x33,0x20,0x70,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x3b,0x0a,0x6f,0x75,
+    0x74,0x20,0x76,0x65,0x63,0x33,0x20,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x3b,0x0a,0x6c,
+    0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,
+    0x20,0x31,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x33,0x20,0x6e,0x6f,0x72,0x6d,
+    0x61,0x6c,0x30,0x3b,0x0a,0x6f,0x75,0x74,0x20,0x76,0x65,0x63,0x32,0x20,0x75,0x76,
+    0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,
+    0x6e,0x20,0x3d,0x20,0x32,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x32,0x20,0x75,
+    0x76,0x30,0x3b,0x0a,0x0a,0x76,0x6f,0x69,0x64,0x20,0x6d,0x61,0x69,0x6e,0x28,0x29,
+    0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,
+    0x6f,0x6e,0x20,0x3d,0x20,0x28,0x6d,0x61,0x74,0x34,0x28,0x76,0x73,0x5f,0x69,0x6e,
+    0x73,0x74,0x61,0x6e,0x63,0x65,0x64,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x30,
+    0x5d,0x2c,0x20,0x76,0x73,0x5f,0x69,0x6e,0x73,0x74,0x61,0x6e,0x63,0x65,0x64,0x5f,
+    0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x31,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x69,0x6e,
+    0x73,0x74,0x61,0x6e,0x63,0x65,0x64,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x32,
+    0x5d,0x2c,0x20,0x76,0x73,0x5f,0x69,0x6e,0x73,0x74,0x61,0x6e,0x63,0x65,0x64,0x5f,
+    0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x33,0x5d,0x29,0x20,0x2a,0x20,0x6d,0x61,0x74,
+    0x34,0x28,0x6d,0x6f,0x64,0x65,0x6c,0x30,0x2c,0x20,0x6d,0x6f,0x64,0x65,0x6c,0x31,
+    0x2c,0x20,0x6d,0x6f,0x64,0x65,0x6c,0x32,0x2c,0x20,0x6d,0x6f,0x64,0x65,0x6c,0x33,
+    0x29,0x29,0x20,0x2a,0x20,0x76,0x65,0x63,0x34,0x28,0x70,0x6f,0x73,0x69,0x74,0x69,
+    0x6f,0x6e,0x2c,0x20,0x31,0x2e,0x30,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x6e,0x6f,
+    0x72,0x6d,0x61,0x6c,0x20,0x3d,0x20,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x30,0x3b,0x0a,
+    0x20,0x20,0x20,0x20,0x75,0x76,0x20,0x3d,0x20,0x75,0x76,0x30,0x3b,0x0a,0x7d,0x0a,
+    0x0a,0x00,
+};
+/*
+    #version 330
+    
+    uniform vec4 vs_quantized_params[6];
+    layout(location = 0) in vec4 position;
+    out vec3 normal;
+    layout(location = 1) in vec2 normal0;
+    out vec2 uv;
+    layout(location = 2) in vec2 uv0;
+    
+    vec3 decode_octahedral(vec2 encoded)
+    {
+        vec3 _normal = vec3(encoded, (1.0 - abs(encoded.x)) - abs(encoded.y));
+        float fold = max(-_normal.z, 0.0);
+        float _1;
+        if (_normal.x >= 0.0)
+        {
+            _1 = -fold;
+        }
+        else
+        {
+            _1 = fold;
+        }
+        _normal.x += _1;
+        float _2;
+        if (_normal.y >= 0.0)
+        {
+            _2 = -fold;
+        }
+        else
+        {
+            _2 = fold;
+        }
+        _normal.y += _2;
+        return normalize(_normal);
+    }
+    
+    void main()
+    {
+        gl_Position = mat4(vs_quantized_params[0], vs_quantized_params[1], vs_quantized_params[2], vs_quantized_params[3]) * vec4(vs_quantized_params[4].xyz + (position.xyz * vs_quantized_params[5].xyz), 1.0);
+        normal = decode_octahedral(normal0);
+        uv = uv0;
+    }
+    
+*/
+static const char vs_quantized_source_glsl330[925] = {
+    0x23,0x76,0x65,0x72,0x73,0x69,0x6f,0x6e,0x20,0x33,0x33,0x30,0x0a,0x0a,0x75,0x6e,
+    0x69,0x66,0x6f,0x72,0x6d,0x20,0x76,0x65,0x63,0x34,0x20,0x76,0x73,0x5f,0x71,0x75,
+    0x61,0x6e,0x74,0x69,0x7a,0x65,0x64,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x36,
+    0x5d,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,
+    0x6f,0x6e,0x20,0x3d,0x20,0x30,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x34,0x20,
+    0x70,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x3b,0x0a,0x6f,0x75,0x74,0x20,0x76,0x65,
+    0x63,0x33,0x20,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,
+    0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x31,0x29,0x20,
+    0x69,0x6e,0x20,0x76,0x65,0x63,0x32,0x20,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x30,0x3b,
+    0x0a,0x6f,0x75,0x74,0x20,0x76,0x65,0x63,0x32,0x20,0x75,0x76,0x3b,0x0a,0x6c,0x61,
+    0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,
+    0x32,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x32,0x20,0x75,0x76,0x30,0x3b,0x0a,
+    0x0a,0x76,0x65,0x63,0x33,0x20,0x64,0x65,0x63,0x6f,0x64,0x65,0x5f,0x6f,0x63,0x74,
+    0x61,0x68,0x65,0x64,0x72,0x61,0x6c,0x28,0x76,0x65,0x63,0x32,0x20,0x65,0x6e,0x63,
+    0x6f,0x64,0x65,0x64,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x63,0x33,
+    0x20,0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x20,0x3d,0x20,0x76,0x65,0x63,0x33,0x28,
+    0x65,0x6e,0x63,0x6f,0x64,0x65,0x64,0x2c,0x20,0x28,0x31,0x2e,0x30,0x20,0x2d,0x20,
+    0x61,0x62,0x73,0x28,0x65,0x6e,0x63,0x6f,0x64,0x65,0x64,0x2e,0x78,0x29,0x29,0x20,
+    0x2d,0x20,0x61,0x62,0x73,0x28,0x65,0x6e,0x63,0x6f,0x64,0x65,0x64,0x2e,0x79,0x29,
+    0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x66,0x6f,0x6c,
+    0x64,0x20,0x3d,0x20,0x6d,0x61,0x78,0x28,0x2d,0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,
+    0x2e,0x7a,0x2c,0x20,0x30,0x2e,0x30,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,
+    0x6f,0x61,0x74,0x20,0x5f,0x31,0x3b,0x0a,0x20,0x20,0x20,0x20,0x69,0x66,0x20,0x28,
+    0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x2e,0x78,0x20,0x3e,0x3d,0x20,0x30,0x2e,0x30,
+    0x29,0x0a,0x20,0x20,0x20,0x20,0x7b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,
+    0x5f,0x31,0x20,0x3d,0x20,0x2d,0x66,0x6f,0x6c,0x64,0x3b,0x0a,0x20,0x20,0x20,0x20,
+    0x7d,0x0a,0x20,0x20,0x20,0x20,0x65,0x6c,0x73,0x65,0x0a,0x20,0x20,0x20,0x20,0x7b,
+    0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x5f,0x31,0x20,0x3d,0x20,0x66,0x6f,
+    0x6c,0x64,0x3b,0x0a,0x20,0x20,0x20,0x20,0x7d,0x0a,0x20,0x20,0x20,0x20,0x5f,0x6e,
+    0x6f,0x72,0x6d,0x61,0x6c,0x2e,0x78,0x20,0x2b,0x3d,0x20,0x5f,0x31,0x3b,0x0a,0x20,
+    0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x5f,0x32,0x3b,0x0a,0x20,0x20,0x20,
+    0x20,0x69,0x66,0x20,0x28,0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x2e,0x79,0x20,0x3e,
+    0x3d,0x20,0x30,0x2e,0x30,0x29,0x0a,0x20,0x20,0x20,0x20,0x7b,0x0a,0x20,0x20,0x20,
+    0x20,0x20,0x20,0x20,0x20,0x5f,0x32,0x20,0x3d,0x20,0x2d,0x66,0x6f,0x6c,0x64,0x3b,
+    0x0a,0x20,0x20,0x20,0x20,0x7d,0x0a,0x20,0x20,0x20,0x20,0x65,0x6c,0x73,0x65,0x0a,
+    0x20,0x20,0x20,0x20,0x7b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x5f,0x32,
+    0x20,0x3d,0x20,0x66,0x6f,0x6c,0x64,0x3b,0x0a,0x20,0x20,0x20,0x20,0x7d,0x0a,0x20,
+    0x20,0x20,0x20,0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x2e,0x79,0x20,0x2b,0x3d,0x20,
+    0x5f,0x32,0x3b,0x0a,0x20,0x20,0x20,0x20,0x72,0x65,0x74,0x75,0x72,0x6e,0x20,0x6e,
+    0x6f,0x72,0x6d,0x61,0x6c,0x69,0x7a,0x65,0x28,0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,
+    0x29,0x3b,0x0a,0x7d,0x0a,0x0a,0x76,0x6f,0x69,0x64,0x20,0x6d,0x61,0x69,0x6e,0x28,
+    0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,
+    0x69,0x6f,0x6e,0x20,0x3d,0x20,0x6d,0x61,0x74,0x34,0x28,0x76,0x73,0x5f,0x71,0x75,
+    0x61,0x6e,0x74,0x69,0x7a,0x65,0x64,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x30,
+    0x5d,0x2c,0x20,0x76,0x73,0x5f,0x71,0x75,0x61,0x6e,0x74,0x69,0x7a,0x65,0x64,0x5f,
+    0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x31,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x71,0x75,
+    0x61,0x6e,0x74,0x69,0x7a,0x65,0x64,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x32,
+    0x5d,0x2c,0x20,0x76,0x73,0x5f,0x71,0x75,0x61,0x6e,0x74,0x69,0x7a,0x65,0x64,0x5f,
+    0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x33,0x5d,0x29,0x20,0x2a,0x20,0x76,0x65,0x63,
+    0x34,0x28,0x76,0x73,0x5f,0x71,0x75,0x61,0x6e,0x74,0x69,0x7a,0x65,0x64,0x5f,0x70,
+    0x61,0x72,0x61,0x6d,0x73,0x5b,0x34,0x5d,0x2e,0x78,0x79,0x7a,0x20,0x2b,0x20,0x28,
+    0x70,0x6f,0x73,0x69,0x74,0x69,0x6f,0x6e,0x2e,0x78,0x79,0x7a,0x20,0x2a,0x20,0x76,
+    0x73,0x5f,0x71,0x75,0x61,0x6e,0x74,0x69,0x7a,0x65,0x64,0x5f,0x70,0x61,0x72,0x61,
+    0x6d,0x73,0x5b,0x35,0x5d,0x2e,0x78,0x79,0x7a,0x29,0x2c,0x20,0x31,0x2e,0x30,0x29,
+    0x3b,0x0a,0x20,0x20,0x20,0x20,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x20,0x3d,0x20,0x64,
+    0x65,0x63,0x6f,0x64,0x65,0x5f,0x6f,0x63,0x74,0x61,0x68,0x65,0x64,0x72,0x61,0x6c,
+    0x28,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x30,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x75,
+    0x76,0x20,0x3d,0x20,0x75,0x76,0x30,0x3b,0x0a,0x7d,0x0a,0x0a,0x00,
+};
+/*
+    #version 330
+    
+    uniform vec4 vs_quantized_instanced_params[6];
+    layout(location = 3) in vec4 model0;
+    layout(location = 4) in vec4 model1;
+    layout(location = 5) in vec4 model2;
+    layout(location = 6) in vec4 model3;
+    layout(location = 0) in vec4 position;
+    out vec3 normal;
+    layout(location = 1) in vec2 normal0;
+    out vec2 uv;
+    layout(location = 2) in vec2 uv0;
+    
+    vec3 decode_octahedral(vec2 encoded)
+    {
+        vec3 _normal = vec3(encoded, (1.0 - abs(encoded.x)) - abs(encoded.y));
+        float fold = max(-_normal.z, 0.0);
+        float _1;
+        if (_normal.x >= 0.0)
+        {
+            _1 = -fold;
+        }
+        else
+        {
+            _1 = fold;
+        }
+        _normal.x += _1;
+        float _2;
+        if (_normal.y >= 0.0)
+        {
+            _2 = -fold;
+        }
+        else
+        {
+            _2 = fold;
+        }
+        _normal.y += _2;
+        return normalize(_normal);
+    }
+    
+    void main()
+    {
+        gl_Position = (mat4(vs_quantized_instanced_params[0], vs_quantized_instanced_params[1], vs_quantized_instanced_params[2], vs_quantized_instanced_params[3]) * mat4(model0, model1, model2, model3)) * vec4(vs_quantized_instanced_params[4].xyz + (position.xyz * vs_quantized_instanced_params[5].xyz), 1.0);
+        normal = decode_octahedral(normal0);
+        uv = uv0;
+    }
+    
+*/
+static const char vs_quantized_instanced_source_glsl330[1184] = {
+    0x23,0x76,0x65,0x72,0x73,0x69,0x6f,0x6e,0x20,0x33,0x33,0x30,0x0a,0x0a,0x75,0x6e,
+    0x69,0x66,0x6f,0x72,0x6d,0x20,0x76,0x65,0x63,0x34,0x20,0x76,0x73,0x5f,0x71,0x75,
+    0x61,0x6e,0x74,0x69,0x7a,0x65,0x64,0x5f,0x69,0x6e,0x73,0x74,0x61,0x6e,0x63,0x65,
+    0x64,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x36,0x5d,0x3b,0x0a,0x6c,0x61,0x79,
+    0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x33,
+    0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x34,0x20,0x6d,0x6f,0x64,0x65,0x6c,0x30,
+    0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,
+    0x6e,0x20,0x3d,0x20,0x34,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x34,0x20,0x6d,
+    0x6f,0x64,0x65,0x6c,0x31,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,
+    0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x35,0x29,0x20,0x69,0x6e,0x20,0x76,
+    0x65,0x63,0x34,0x20,0x6d,0x6f,0x64,0x65,0x6c,0x32,0x3b,0x0a,0x6c,0x61,0x79,0x6f,
+    0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x36,0x29,
+    0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x34,0x20,0x6d,0x6f,0x64,0x65,0x6c,0x33,0x3b,
+    0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,
+    0x20,0x3d,0x20,0x30,0x29,0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x34,0x20,0x70,0x6f,
+    0x73,0x69,0x74,0x69,0x6f,0x6e,0x3b,0x0a,0x6f,0x75,0x74,0x20,0x76,0x65,0x63,0x33,
+    0x20,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x3b,0x0a,0x6c,0x61,0x79,0x6f,0x75,0x74,0x28,
+    0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x31,0x29,0x20,0x69,0x6e,
+    0x20,0x76,0x65,0x63,0x32,0x20,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x30,0x3b,0x0a,0x6f,
+    0x75,0x74,0x20,0x76,0x65,0x63,0x32,0x20,0x75,0x76,0x3b,0x0a,0x6c,0x61,0x79,0x6f,
+    0x75,0x74,0x28,0x6c,0x6f,0x63,0x61,0x74,0x69,0x6f,0x6e,0x20,0x3d,0x20,0x32,0x29,
+    0x20,0x69,0x6e,0x20,0x76,0x65,0x63,0x32,0x20,0x75,0x76,0x30,0x3b,0x0a,0x0a,0x76,
+    0x65,0x63,0x33,0x20,0x64,0x65,0x63,0x6f,0x64,0x65,0x5f,0x6f,0x63,0x74,0x61,0x68,
+    0x65,0x64,0x72,0x61,0x6c,0x28,0x76,0x65,0x63,0x32,0x20,0x65,0x6e,0x63,0x6f,0x64,
+    0x65,0x64,0x29,0x0a,0x7b,0x0a,0x20,0x20,0x20,0x20,0x76,0x65,0x63,0x33,0x20,0x5f,
+    0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x20,0x3d,0x20,0x76,0x65,0x63,0x33,0x28,0x65,0x6e,
+    0x63,0x6f,0x64,0x65,0x64,0x2c,0x20,0x28,0x31,0x2e,0x30,0x20,0x2d,0x20,0x61,0x62,
+    0x73,0x28,0x65,0x6e,0x63,0x6f,0x64,0x65,0x64,0x2e,0x78,0x29,0x29,0x20,0x2d,0x20,
+    0x61,0x62,0x73,0x28,0x65,0x6e,0x63,0x6f,0x64,0x65,0x64,0x2e,0x79,0x29,0x29,0x3b,
+    0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x66,0x6f,0x6c,0x64,0x20,
+    0x3d,0x20,0x6d,0x61,0x78,0x28,0x2d,0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x2e,0x7a,
+    0x2c,0x20,0x30,0x2e,0x30,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x66,0x6c,0x6f,0x61,
+    0x74,0x20,0x5f,0x31,0x3b,0x0a,0x20,0x20,0x20,0x20,0x69,0x66,0x20,0x28,0x5f,0x6e,
+    0x6f,0x72,0x6d,0x61,0x6c,0x2e,0x78,0x20,0x3e,0x3d,0x20,0x30,0x2e,0x30,0x29,0x0a,
+    0x20,0x20,0x20,0x20,0x7b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x5f,0x31,
+    0x20,0x3d,0x20,0x2d,0x66,0x6f,0x6c,0x64,0x3b,0x0a,0x20,0x20,0x20,0x20,0x7d,0x0a,
+    0x20,0x20,0x20,0x20,0x65,0x6c,0x73,0x65,0x0a,0x20,0x20,0x20,0x20,0x7b,0x0a,0x20,
+    0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x5f,0x31,0x20,0x3d,0x20,0x66,0x6f,0x6c,0x64,
+    0x3b,0x0a,0x20,0x20,0x20,0x20,0x7d,0x0a,0x20,0x20,0x20,0x20,0x5f,0x6e,0x6f,0x72,
+    0x6d,0x61,0x6c,0x2e,0x78,0x20,0x2b,0x3d,0x20,0x5f,0x31,0x3b,0x0a,0x20,0x20,0x20,
+    0x20,0x66,0x6c,0x6f,0x61,0x74,0x20,0x5f,0x32,0x3b,0x0a,0x20,0x20,0x20,0x20,0x69,
+    0x66,0x20,0x28,0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x2e,0x79,0x20,0x3e,0x3d,0x20,
+    0x30,0x2e,0x30,0x29,0x0a,0x20,0x20,0x20,0x20,0x7b,0x0a,0x20,0x20,0x20,0x20,0x20,
+    0x20,0x20,0x20,0x5f,0x32,0x20,0x3d,0x20,0x2d,0x66,0x6f,0x6c,0x64,0x3b,0x0a,0x20,
+    0x20,0x20,0x20,0x7d,0x0a,0x20,0x20,0x20,0x20,0x65,0x6c,0x73,0x65,0x0a,0x20,0x20,
+    0x20,0x20,0x7b,0x0a,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x20,0x5f,0x32,0x20,0x3d,
+    0x20,0x66,0x6f,0x6c,0x64,0x3b,0x0a,0x20,0x20,0x20,0x20,0x7d,0x0a,0x20,0x20,0x20,
+    0x20,0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x2e,0x79,0x20,0x2b,0x3d,0x20,0x5f,0x32,
+    0x3b,0x0a,0x20,0x20,0x20,0x20,0x72,0x65,0x74,0x75,0x72,0x6e,0x20,0x6e,0x6f,0x72,
+    0x6d,0x61,0x6c,0x69,0x7a,0x65,0x28,0x5f,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x29,0x3b,
+    0x0a,0x7d,0x0a,0x0a,0x76,0x6f,0x69,0x64,0x20,0x6d,0x61,0x69,0x6e,0x28,0x29,0x0a,
+    0x7b,0x0a,0x20,0x20,0x20,0x20,0x67,0x6c,0x5f,0x50,0x6f,0x73,0x69,0x74,0x69,0x6f,
+    0x6e,0x20,0x3d,0x20,0x28,0x6d,0x61,0x74,0x34,0x28,0x76,0x73,0x5f,0x71,0x75,0x61,
+    0x6e,0x74,0x69,0x7a,0x65,0x64,0x5f,0x69,0x6e,0x73,0x74,0x61,0x6e,0x63,0x65,0x64,
+    0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x30,0x5d,0x2c,0x20,0x76,0x73,0x5f,0x71,
+    0x75,0x61,0x6e,0x74,0x69,0x7a,0x65,0x64,0x5f,0x69,0x6e,0x73,0x74,0x61,0x6e,0x63,
+    0x65,0x64,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x31,0x5d,0x2c,0x20,0x76,0x73,
+    0x5f,0x71,0x75,0x61,0x6e,0x74,0x69,0x7a,0x65,0x64,0x5f,0x69,0x6e,0x73,0x74,0x61,
+    0x6e,0x63,0x65,0x64,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x32,0x5d,0x2c,0x20,
+    0x76,0x73,0x5f,0x71,0x75,0x61,0x6e,0x74,0x69,0x7a,0x65,0x64,0x5f,0x69,0x6e,0x73,
+    0x74,0x61,0x6e,0x63,0x65,0x64,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x33,0x5d,
+    0x29,0x20,0x2a,0x20,0x6d,0x61,0x74,0x34,0x28,0x6d,0x6f,0x64,0x65,0x6c,0x30,0x2c,
+    0x20,0x6d,0x6f,0x64,0x65,0x6c,0x31,0x2c,0x20,0x6d,0x6f,0x64,0x65,0x6c,0x32,0x2c,
+    0x20,0x6d,0x6f,0x64,0x65,0x6c,0x33,0x29,0x29,0x20,0x2a,0x20,0x76,0x65,0x63,0x34,
+    0x28,0x76,0x73,0x5f,0x71,0x75,0x61,0x6e,0x74,0x69,0x7a,0x65,0x64,0x5f,0x69,0x6e,
+    0x73,0x74,0x61,0x6e,0x63,0x65,0x64,0x5f,0x70,0x61,0x72,0x61,0x6d,0x73,0x5b,0x34,
+    0x5d,0x2e,0x78,0x79,0x7a,0x20,0x2b,0x20,0x28,0x70,0x6f,0x73,0x69,0x74,0x69,0x6f,
+    0x6e,0x2e,0x78,0x79,0x7a,0x20,0x2a,0x20,0x76,0x73,0x5f,0x71,0x75,0x61,0x6e,0x74,
+    0x69,0x7a,0x65,0x64,0x5f,0x69,0x6e,0x73,0x74,0x61,0x6e,0x63,0x65,0x64,0x5f,0x70,
+    0x61,0x72,0x61,0x6d,0x73,0x5b,0x35,0x5d,0x2e,0x78,0x79,0x7a,0x29,0x2c,0x20,0x31,
+    0x2e,0x30,0x29,0x3b,0x0a,0x20,0x20,0x20,0x20,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x20,
+    0x3d,0x20,0x64,0x65,0x63,0x6f,0x64,0x65,0x5f,0x6f,0x63,0x74,0x61,0x68,0x65,0x64,
+    0x72,0x61,0x6c,0x28,0x6e,0x6f,0x72,0x6d,0x61,0x6c,0x30,0x29,0x3b,0x0a,0x20,0x20,
+    0x20,0x20,0x75,0x76,0x20,0x3d,0x20,0x75,0x76,0x30,0x3b,0x0a,0x7d,0x0a,0x0a,0x00,
+};
+/*
+    #version 330
+    
     layout(location = 0) out vec4 frag_color;
     in vec3 normal;
     in vec2 uv;
@@ -166,3 +612,83 @@ static inline const sg_shader_desc* unlit_shader_desc(sg_backend backend) {
   }
   return 0;
 }
+static inline const sg_shader_desc* unlit_instanced_shader_desc(sg_backend backend) {
+  if (backend == SG_BACKEND_GLCORE33) {
+    static sg_shader_desc desc;
+    static bool valid;
+    if (!valid) {
+      valid = true;
+      desc.attrs[0].name = "position";
+      desc.attrs[1].name = "normal0";
+      desc.attrs[2].name = "uv0";
+      desc.attrs[3].name = "model0";
+      desc.attrs[4].name = "model1";
+      desc.attrs[5].name = "model2";
+      desc.attrs[6].name = "model3";
+      desc.vs.source = vs_instanced_source_glsl330;
+      desc.vs.entry = "main";
+      desc.vs.uniform_blocks[0].size = 64;
+      desc.vs.uniform_blocks[0].layout = SG_UNIFORMLAYOUT_STD140;
+      desc.vs.uniform_blocks[0].uniforms[0].name = "vs_instanced_params";
+      desc.vs.uniform_blocks[0].uniforms[0].type = SG_UNIFORMTYPE_FLOAT4;
+      desc.vs.uniform_blocks[0].uniforms[0].array_count = 4;
+      desc.fs.source = fs_source_glsl330;
+      desc.fs.entry = "main";
+      desc.label = "unlit_instanced_shader";
+    }
+    return &desc;
+  }
+  return 0;
+}
+static inline const sg_shader_desc* unlit_quantized_shader_desc(sg_backend backend) {
+  if (backend == SG_BACKEND_GLCORE33) {
+    static sg_shader_desc desc;
+    static bool valid;
+    if (!valid) {
+      valid = true;
+      desc.attrs[0].name = "position";
+      desc.attrs[1].name = "normal0";
+      desc.attrs[2].name = "uv0";
+      desc.vs.source = vs_quantized_source_glsl330;
+      desc.vs.entry = "main";
+      desc.vs.uniform_blocks[0].size = 96;
+      desc.vs.uniform_blocks[0].layout = SG_UNIFORMLAYOUT_STD140;
+      desc.vs.uniform_blocks[0].uniforms[0].name = "vs_quantized_params";
+      desc.vs.uniform_blocks[0].uniforms[0].type = SG_UNIFORMTYPE_FLOAT4;
+      desc.vs.uniform_blocks[0].uniforms[0].array_count = 6;
+      desc.fs.source = fs_source_glsl330;
+      desc.fs.entry = "main";
+      desc.label = "unlit_quantized_shader";
+    }
+    return &desc;
+  }
+  return 0;
+}
+static inline const sg_shader_desc* unlit_quantized_instanced_shader_desc(sg_backend backend) {
+  if (backend == SG_BACKEND_GLCORE33) {
+    static sg_shader_desc desc;
+    static bool valid;
+    if (!valid) {
+      valid = true;
+      desc.attrs[0].name = "position";
+      desc.attrs[1].name = "normal0";
+      desc.attrs[2].name = "uv0";
+      desc.attrs[3].name = "model0";
+      desc.attrs[4].name = "model1";
+      desc.attrs[5].name = "model2";
+      desc.attrs[6].name = "model3";
+      desc.vs.source = vs_quantized_instanced_source_glsl330;
+      desc.vs.entry = "main";
+      desc.vs.uniform_blocks[0].size = 96;
+      desc.vs.uniform_blocks[0].layout = SG_UNIFORMLAYOUT_STD140;
+      desc.vs.uniform_blocks[0].uniforms[0].name = "vs_quantized_instanced_params";
+      desc.vs.uniform_blocks[0].uniforms[0].type = SG_UNIFORMTYPE_FLOAT4;
+      desc.vs.uniform_blocks[0].uniforms[0].array_count = 6;
+      desc.fs.source = fs_source_glsl330;
+      desc.fs.entry = "main";
+      desc.label = "unlit_quantized_instanced_shader";
+    }
+    return &desc;
+  }
+  return 0;
+}
@@ -0,0 +1,426 @@
+#include "spatial.hpp"
+#include <cmath>
+#include <utility>
+
+namespace spatial {
+
+static f32 perimeter(const AABB &aabb) {
+  const HMM_Vec3 size = aabb.max - aabb.min;
+
+  return 2.0f * (size.X * size.Y + size.Y * size.Z + size.Z * size.X);
+}
+
+AABB transform_bounds(const comps::Bounds &bounds, const HMM_Mat4 &world) {
+  const HMM_Vec3 center = (world * HMM_V4V(bounds.center, 1.0f)).XYZ;
+
+  HMM_Vec3 extents = HMM_V3(0.0f, 0.0f, 0.0f);
+
+  for (i32 i_column = 0; i_column < 3; i_column++) {
+    const HMM_Vec3 axis = world.Columns[i_column].XYZ * bounds.extents.Elements[i_column];
+
+    extents += HMM_V3(fabsf(axis.X), fabsf(axis.Y), fabsf(axis.Z));
+  }
+
+  return {.min = center - extents, .max = center + extents};
+}
+
+bool overlaps_sphere(const AABB &aabb, const HMM_Vec3 center, const f32 radius) {
+  f32 distance_sq = 0.0f;
+
+  for (i32 i_axis = 0; i_axis < 3; i_axis++) {
+    const f32 value = center.Elements[i_axis];
+
+    if (value < aabb.min.Elements[i_axis]) {
+      const f32 delta = aabb.min.Elements[i_axis] - value;
+      distance_sq += delta * delta;
+    } else if (value > aabb.max.Elements[i_axis]) {
+      const f32 delta = value - aabb.max.Elements[i_axis];
+      distance_sq += delta * delta;
+    }
+  }
+
+  return distance_sq <= radius * radius;
+}
+
+bool intersect_ray(const Ray &ray, const AABB &aabb, f32 &out_distance) {
+  f32 t_min = 0.0f;
+  f32 t_max = ray.max_distance;
+
+  for (i32 i_axis = 0; i_axis < 3; i_axis++) {
+    const f32 origin = ray.origin.Elements[i_axis];
+    const f32 direction = ray.direction.Elements[i_axis];
+
+    if (fabsf(direction) < 1e-8f) {
+      if (origin < aabb.min.Elements[i_axis] || origin > aabb.max.Elements[i_axis]) {
+        return false;
+      }
+
+      continue;
+    }
+
+    const f32 inv_direction = 1.0f / direction;
+
+    f32 t_near = (aabb.min.Elements[i_axis] - origin) * inv_direction;
+    f32 t_far = (aabb.max.Elements[i_axis] - origin) * inv_direction;
+
+    if (t_near > t_far) {
+      std::swap(t_near, t_far);
+    }
+
+    t_min = HMM_MAX(t_min, t_near);
+    t_max = HMM_MIN(t_max, t_far);
+
+    if (t_min > t_max) {
+      return false;
+    }
+  }
+
+  out_distance = t_min;
+
+  return true;
+}
+
+Containment classify(const culling::Frustum &frustum, const AABB &aabb) {
+  const HMM_Vec3 center = (aabb.min + aabb.max) * 0.5f;
+  const HMM_Vec3 extents = (aabb.max - aabb.min) * 0.5f;
+
+  Containment result = Containment::INSIDE;
+
+  for (const HMM_Vec4 &plane : frustum.planes) {
+    const f32 distance = HMM_DotV3(plane.XYZ, center) + plane.W;
+    const f32 radius = fabsf(plane.X) * extents.X + fabsf(plane.Y) * extents.Y + fabsf(plane.Z) * extents.Z;
+
+    if (distance < -radius) {
+      return Containment::OUTSIDE;
+    }
+
+    if (distance < radius) {
+      result = Containment::INTERSECTING;
+    }
+  }
+
+  return result;
+}
+
+// tree
+
+i32 Tree::allocate_node() {
+  i32 node_id;
+
+  if (_free_list == null_node) {
+    node_id = static_cast<i32>(_nodes.size());
+    _nodes.emplace_back(Node{});
+  } else {
+    node_id = _free_list;
+    _free_list = _nodes[node_id].parent;
+  }
+
+  _nodes[node_id] = Node{
+      .aabb = {},
+      .user = 0,
+      .parent = null_node,
+      .child_a = null_node,
+      .child_b = null_node,
+      .height = 0,
+  };
+
+  return node_id;
+}
+
+void Tree::free_node(const i32 node_id) {
+  _nodes[node_id].parent = _free_list;
+  _nodes[node_id].height = -1;
+  _free_list = node_id;
+}
+
+void Tree::insert_leaf(const i32 leaf) {
+  if (_root == null_node) {
+    _root = leaf;
+    _nodes[leaf].parent = null_node;
+    return;
+  }
+
+  // find the cheapest sibling by surface area heuristic
+
+  const AABB leaf_aabb = _nodes[leaf].aabb;
+
+  i32 index = _root;
+
+  while (!_nodes[index].is_leaf()) {
+    const Node &node = _nodes[index];
+
+    const f32 area = perimeter(node.aabb);
+    const f32 combined_area = perimeter(merge(node.aabb, leaf_aabb));
+
+    // cost of creating a new parent for this node and the leaf
+    const f32 cost = 2.0f * combined_area;
+
+    // minimum cost of pushing the leaf further down the tree
+    const f32 inheritance_cost = 2.0f * (combined_area - area);
+
+    const auto descend_cost = [&](const i32 child_id) {
+      const Node &child = _nodes[child_id];
+      const f32 merged_area = perimeter(merge(leaf_aabb, child.aabb));
+
+      if (child.is_leaf()) {
+        return merged_area + inheritance_cost;
+      }
+
+      return merged_area - perimeter(child.aabb) + inheritance_cost;
+    };
+
+    const f32 cost_a = descend_cost(node.child_a);
+    const f32 cost_b = descend_cost(node.child_b);
+
+    if (cost < cost_a && cost < cost_b) {
+      break;
+    }
+
+    index = cost_a < cost_b ? node.child_a : node.child_b;
+  }
+
+  const i32 sibling = index;
+
+  // create a new parent
+
+  const i32 old_parent = _nodes[sibling].parent;
+  const i32 new_parent = allocate_node();
+
+  _nodes[new_parent].parent = old_parent;
+  _nodes[new_parent].aabb = merge(leaf_aabb, _nodes[sibling].aabb);
+  _nodes[new_parent].height = _nodes[sibling].height + 1;
+  _nodes[new_parent].child_a = sibling;
+  _nodes[new_parent].child_b = leaf;
+
+  _nodes[sibling].parent = new_parent;
+  _nodes[leaf].parent = new_parent;
+
+  if (old_parent != null_node) {
+    if (_nodes[old_parent].child_a == sibling) {
+      _nodes[old_parent].child_a = new_parent;
+    } else {
+      _nodes[old_parent].child_b = new_parent;
+    }
+  } else {
+    _root = new_parent;
+  }
+
+  // refit and rebalance the ancestors
+
+  index = _nodes[leaf].parent;
+
+  while (index != null_node) {
+    index = balance(index);
+
+    Node &node = _nodes[index];
+    const Node &child_a = _nodes[node.child_a];
+    const Node &child_b = _nodes[node.child_b];
+
+    node.height = 1 + HMM_MAX(child_a.height, child_b.height);
+    node.aabb = merge(child_a.aabb, child_b.aabb);
+
+    index = node.parent;
+  }
+}
+
+void Tree::remove_leaf(const i32 leaf) {
+  if (leaf == _root) {
+    _root = null_node;
+    return;
+  }
+
+  const i32 parent = _nodes[leaf].parent;
+  const i32 grand_parent = _nodes[parent].parent;
+  const i32 sibling = _nodes[parent].child_a == leaf ? _nodes[parent].child_b : _nodes[parent].child_a;
+
+  free_node(parent);
+
+  if (grand_parent == null_node) {
+    _root = sibling;
+    _nodes[sibling].parent = null_node;
+    return;
+  }
+
+  // replace the parent with the sibling
+
+  if (_nodes[grand_parent].child_a == parent) {
+    _nodes[grand_parent].child_a = sibling;
+  } else {
+    _nodes[grand_parent].child_b = sibling;
+  }
+
+  _nodes[sibling].parent = grand_parent;
+
+  i32 index = grand_parent;
+
+  while (index != null_node) {
+    index = balance(index);
+
+    Node &node = _nodes[index];
+    const Node &child_a = _nodes[node.child_a];
+    const Node &child_b = _nodes[node.child_b];
+
+    node.aabb = merge(child_a.aabb, child_b.aabb);
+    node.height = 1 + HMM_MAX(child_a.height, child_b.height);
+
+    index = node.parent;
+  }
+}
+
+// rotates the higher child of a up if the subtree is imbalanced, returns the new subtree root
+i32 Tree::balance(const i32 i_a) {
+  Node &a = _nodes[i_a];
+
+  if (a.is_leaf() || a.height < 2) {
+    return i_a;
+  }
+
+  const i32 i_b = a.child_a;
+  const i32 i_c = a.child_b;
+
+  Node &b = _nodes[i_b];
+  Node &c = _nodes[i_c];
+
+  const i32 height_difference = c.height - b.height;
+
+  const auto replace_in_parent = [&](const i32 parent, const i32 old_child, const i32 new_child) {
+    if (parent == null_node) {
+      _root = new_child;
+    } else if (_nodes[parent].child_a == old_child) {
+      _nodes[parent].child_a = new_child;
+    } else {
+      _nodes[parent].child_b = new_child;
+    }
+  };
+
+  // rotate c up
+  if (height_difference > 1) {
+    const i32 i_f = c.child_a;
+    const i32 i_g = c.child_b;
+
+    Node &f = _nodes[i_f];
+    Node &g = _nodes[i_g];
+
+    c.child_a = i_a;
+    c.parent = a.parent;
+    a.parent = i_c;
+
+    replace_in_parent(c.parent, i_a, i_c);
+
+    if (f.height > g.height) {
+      c.child_b = i_f;
+      a.child_b = i_g;
+      g.parent = i_a;
+
+      a.aabb = merge(b.aabb, g.aabb);
+      c.aabb = merge(a.aabb, f.aabb);
+
+      a.height = 1 + HMM_MAX(b.height, g.height);
+      c.height = 1 + HMM_MAX(a.height, f.height);
+    } else {
+      c.child_b = i_g;
+      a.child_b = i_f;
+      f.parent = i_a;
+
+      a.aabb = merge(b.aabb, f.aabb);
+      c.aabb = merge(a.aabb, g.aabb);
+
+      a.height = 1 + HMM_MAX(b.height, f.height);
+      c.height = 1 + HMM_MAX(a.height, g.height);
+    }
+
+    return i_c;
+  }
+
+  // rotate b up
+  if (height_difference < -1) {
+    const i32 i_d = b.child_a;
+    const i32 i_e = b.child_b;
+
+    Node &d = _nodes[i_d];
+    Node &e = _nodes[i_e];
+
+    b.child_a = i_a;
+    b.parent = a.parent;
+    a.parent = i_b;
+
+    replace_in_parent(b.parent, i_a, i_b);
+
+    if (d.height > e.height) {
+      b.child_b = i_d;
+      a.child_a = i_e;
+      e.parent = i_a;
+
+      a.aabb = merge(c.aabb, e.aabb);
+      b.aabb = merge(a.aabb, d.aabb);
+
+      a.height = 1 + HMM_MAX(c.height, e.height);
+      b.height = 1 + HMM_MAX(a.height, d.height);
+    } else {
+      b.child_b = i_e;
+      a.child_a = i_d;
+      d.parent = i_a;
+
+      a.aabb = merge(c.aabb, d.aabb);
+      b.aabb = merge(a.aabb, e.aabb);
+
+      a.height = 1 + HMM_MAX(c.height, d.height);
+      b.height = 1 + HMM_MAX(a.height, e.height);
+    }
+
+    return i_b;
+  }
+
+  return i_a;
+}
+
+i32 Tree::insert(const AABB &aabb, const u64 user) {
+  const i32 proxy = allocate_node();
+
+  const HMM_Vec3 fat_margin = HMM_V3(margin, margin, margin);
+
+  _nodes[proxy].aabb = {.min = aabb.min - fat_margin, .max = aabb.max + fat_margin};
+  _nodes[proxy].user = user;
+
+  insert_leaf(proxy);
+
+  _leaf_count++;
+
+  return proxy;
+}
+
+void Tree::remove(const i32 proxy) {
+  LOG_ASSERT(_nodes[proxy].is_leaf());
+
+  remove_leaf(proxy);
+  free_node(proxy);
+
+  _leaf_count--;
+}
+
+bool Tree::move(const i32 proxy, const AABB &aabb) {
+  LOG_ASSERT(_nodes[proxy].is_leaf());
+
+  if (contains(_nodes[proxy].aabb, aabb)) {
+    return false;
+  }
+
+  remove_leaf(proxy);
+
+  const HMM_Vec3 fat_margin = HMM_V3(margin, margin, margin);
+
+  _nodes[proxy].aabb = {.min = aabb.min - fat_margin, .max = aabb.max + fat_margin};
+
+  insert_leaf(proxy);
+
+  return true;
+}
+
+void Tree::release() {
+  _nodes.release();
+  _root = null_node;
+  _free_list = null_node;
+  _leaf_count = 0;
+}
+
+} // namespace spatial
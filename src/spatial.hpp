@@ -0,0 +1,267 @@
+#pragma once
+
+#include "components.hpp"
+#include "culling.hpp"
+#include "engine.hpp"
+
+namespace spatial {
+
+struct AABB {
+  HMM_Vec3 min;
+  HMM_Vec3 max;
+};
+
+struct Ray {
+  HMM_Vec3 origin;
+  HMM_Vec3 direction;
+  f32 max_distance;
+};
+
+constexpr i32 null_node = -1;
+
+// upper bound for the traversal stack, the tree is height balanced so this covers far more than 1M leaves
+constexpr usize query_stack_size = 256;
+
+[[nodiscard]] AABB transform_bounds(const comps::Bounds &bounds, const HMM_Mat4 &world);
+
+[[nodiscard]] inline AABB merge(const AABB &a, const AABB &b) {
+  return {
+      .min = HMM_V3(HMM_MIN(a.min.X, b.min.X), HMM_MIN(a.min.Y, b.min.Y), HMM_MIN(a.min.Z, b.min.Z)),
+      .max = HMM_V3(HMM_MAX(a.max.X, b.max.X), HMM_MAX(a.max.Y, b.max.Y), HMM_MAX(a.max.Z, b.max.Z)),
+  };
+}
+
+[[nodiscard]] inline bool overlaps(const AABB &a, const AABB &b) {
+  return a.min.X <= b.max.X && a.max.X >= b.min.X && a.min.Y <= b.max.Y && a.max.Y >= b.min.Y &&
+         a.min.Z <= b.max.Z && a.max.Z >= b.min.Z;
+}
+
+[[nodiscard]] inline bool contains(const AABB &outer, const AABB &inner) {
+  return outer.min.X <= inner.min.X && outer.min.Y <= inner.min.Y && outer.min.Z <= inner.min.Z &&
+         outer.max.X >= inner.max.X && outer.max.Y >= inner.max.Y && outer.max.Z >= inner.max.Z;
+}
+
+[[nodiscard]] bool overlaps_sphere(const AABB &aabb, const HMM_Vec3 center, const f32 radius);
+
+// returns the entry distance along the ray, or false if the ray misses the box within max_distance
+[[nodiscard]] bool intersect_ray(const Ray &ray, const AABB &aabb, f32 &out_distance);
+
+enum class Containment {
+  OUTSIDE,
+  INTERSECTING,
+  INSIDE,
+};
+
+[[nodiscard]] Containment classify(const culling::Frustum &frustum, const AABB &aabb);
+
+// dynamic bounding volume hierarchy over fattened leaf boxes, leaves are only reinserted once they leave their box
+struct Tree {
+  struct Node {
+    AABB aabb;
+    u64 user;
+
+    // next free node while on the free list
+    i32 parent;
+    i32 child_a;
+    i32 child_b;
+
+    // -1 while on the free list
+    i32 height;
+
+    [[nodiscard]] bool is_leaf() const { return child_a == null_node; }
+  };
+
+  f32 margin = 0.25f;
+
+private:
+  utils::DSArray<Node> _nodes;
+  i32 _root = null_node;
+  i32 _free_list = null_node;
+  usize _leaf_count = 0;
+
+  i32 allocate_node();
+  void free_node(const i32 node);
+
+  void insert_leaf(const i32 leaf);
+  void remove_leaf(const i32 leaf);
+
+  i32 balance(const i32 node);
+
+public:
+  i32 insert(const AABB &aabb, const u64 user);
+
+  void remove(const i32 proxy);
+
+  // returns true if the proxy had to be reinserted
+  bool move(const i32 proxy, const AABB &aabb);
+
+  [[nodiscard]] u64 get_user(const i32 proxy) const { return _nodes[proxy].user; }
+
+  [[nodiscard]] const AABB &get_fat_aabb(const i32 proxy) const { return _nodes[proxy].aabb; }
+
+  [[nodiscard]] usize leaf_count() const { return _leaf_count; }
+
+  [[nodiscard]] i32 height() const { return _root == null_node ? 0 : _nodes[_root].height; }
+
+  // callback(u64 user) -> bool, return false to stop the query
+  template <typename Callback> void query_aabb(const AABB &aabb, Callback &&callback) const;
+
+  // callback(u64 user) -> bool, return false to stop the query
+  template <typename Callback>
+  void query_sphere(const HMM_Vec3 center, const f32 radius, Callback &&callback) const;
+
+  // callback(u64 user, bool inside) -> bool, inside is set when the leaf box lies fully within the frustum
+  template <typename Callback> void query_frustum(const culling::Frustum &frustum, Callback &&callback) const;
+
+  // callback(u64 user, f32 distance) -> f32, returns the new max distance, 0 stops the query
+  template <typename Callback> void query_ray(const Ray &ray, Callback &&callback) const;
+
+  void release();
+};
+
+template <typename Callback> void Tree::query_aabb(const AABB &aabb, Callback &&callback) const {
+  if (_root == null_node) {
+    return;
+  }
+
+  i32 stack[query_stack_size];
+  usize stack_size = 0;
+
+  stack[stack_size++] = _root;
+
+  while (stack_size > 0) {
+    const Node &node = _nodes[stack[--stack_size]];
+
+    if (!overlaps(node.aabb, aabb)) {
+      continue;
+    }
+
+    if (node.is_leaf()) {
+      if (!callback(node.user)) {
+        return;
+      }
+    } else {
+      LOG_ASSERT(stack_size + 2 <= query_stack_size);
+
+      stack[stack_size++] = node.child_a;
+      stack[stack_size++] = node.child_b;
+    }
+  }
+}
+
+template <typename Callback>
+void Tree::query_sphere(const HMM_Vec3 center, const f32 radius, Callback &&callback) const {
+  if (_root == null_node) {
+    return;
+  }
+
+  i32 stack[query_stack_size];
+  usize stack_size = 0;
+
+  stack[stack_size++] = _root;
+
+  while (stack_size > 0) {
+    const Node &node = _nodes[stack[--stack_size]];
+
+    if (!overlaps_sphere(node.aabb, center, radius)) {
+      continue;
+    }
+
+    if (node.is_leaf()) {
+      if (!callback(node.user)) {
+        return;
+      }
+    } else {
+      LOG_ASSERT(stack_size + 2 <= query_stack_size);
+
+      stack[stack_size++] = node.child_a;
+      stack[stack_size++] = node.child_b;
+    }
+  }
+}
+
+template <typename Callback> void Tree::query_frustum(const culling::Frustum &frustum, Callback &&callback) const {
+  if (_root == null_node) {
+    return;
+  }
+
+  i32 stack[query_stack_size];
+  bool stack_inside[query_stack_size];
+  usize stack_size = 0;
+
+  stack[stack_size] = _root;
+  stack_inside[stack_size] = false;
+  stack_size++;
+
+  while (stack_size > 0) {
+    stack_size--;
+
+    const Node &node = _nodes[stack[stack_size]];
+    bool inside = stack_inside[stack_size];
+
+    // children of a fully contained node need no plane tests
+    if (!inside) {
+      const Containment containment = classify(frustum, node.aabb);
+
+      if (containment == Containment::OUTSIDE) {
+        continue;
+      }
+
+      inside = containment == Containment::INSIDE;
+    }
+
+    if (node.is_leaf()) {
+      if (!callback(node.user, inside)) {
+        return;
+      }
+    } else {
+      LOG_ASSERT(stack_size + 2 <= query_stack_size);
+
+      stack[stack_size] = node.child_a;
+      stack_inside[stack_size] = inside;
+      stack_size++;
+
+      stack[stack_size] = node.child_b;
+      stack_inside[stack_size] = inside;
+      stack_size++;
+    }
+  }
+}
+
+template <typename Callback> void Tree::query_ray(const Ray &ray, Callback &&callback) const {
+  if (_root == null_node) {
+    return;
+  }
+
+  Ray clipped_ray = ray;
+
+  i32 stack[query_stack_size];
+  usize stack_size = 0;
+
+  stack[stack_size++] = _root;
+
+  while (stack_size > 0) {
+    const Node &node = _nodes[stack[--stack_size]];
+
+    f32 distance;
+
+    if (!intersect_ray(clipped_ray, node.aabb, distance)) {
+      continue;
+    }
+
+    if (node.is_leaf()) {
+      clipped_ray.max_distance = callback(node.user, distance);
+
+      if (clipped_ray.max_distance <= 0.0f) {
+        return;
+      }
+    } else {
+      LOG_ASSERT(stack_size + 2 <= query_stack_size);
+
+      stack[stack_size++] = node.child_a;
+      stack[stack_size++] = node.child_b;
+    }
+  }
+}
+
+} // namespace spatial
@@ -0,0 +1,328 @@
+#include "transforms.hpp"
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TRANSFORMS_SSE
+#include <immintrin.h>
+#endif
+
+#if defined(TRANSFORMS_SSE) && defined(__GNUC__)
+#define TRANSFORMS_AVX
+#endif
+
+namespace transforms {
+
+Backend get_backend() {
+#ifdef TRANSFORMS_AVX
+  if (__builtin_cpu_supports("avx")) {
+    return Backend::AVX;
+  }
+#endif
+
+#ifdef TRANSFORMS_SSE
+  return Backend::SSE;
+#else
+  return Backend::SCALAR;
+#endif
+}
+
+const c8 *get_backend_name(const Backend backend) {
+  switch (backend) {
+  case Backend::SCALAR:
+    return "scalar";
+  case Backend::SSE:
+    return "sse";
+  case Backend::AVX:
+    return "avx";
+  }
+
+  return "unknown";
+}
+
+static void compose_world_scalar(const comps::LocalTransform *locals, comps::WorldMatrix *worlds, const u32 *indices,
+                                 const usize begin, const usize end, const HMM_Mat4 *parent) {
+  for (usize i = begin; i < end; i++) {
+    const comps::LocalTransform &local = locals[indices[i]];
+    HMM_Mat4 &matrix = worlds[indices[i]].matrix;
+
+    matrix = HMM_QToM4(local.rotation);
+    HMM_TranslateInplace(matrix, local.translation);
+
+    if (parent != nullptr) {
+      matrix = *parent * matrix;
+    }
+  }
+}
+
+#ifdef TRANSFORMS_SSE
+
+// the sse and avx kernels load the translation as four floats, the fourth is the rotation's x
+static_assert(offsetof(comps::LocalTransform, rotation) ==
+              offsetof(comps::LocalTransform, translation) + sizeof(HMM_Vec3));
+
+static void compose_world_sse(const comps::LocalTransform *locals, comps::WorldMatrix *worlds, const u32 *indices,
+                              const usize count, const HMM_Mat4 *parent) {
+  constexpr usize width = 4;
+
+  const usize simd_count = count - count % width;
+
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 two = _mm_set1_ps(2.0f);
+  const __m128 zero = _mm_setzero_ps();
+
+  // broadcast parent, p[column][row]
+  __m128 p[4][4];
+
+  if (parent != nullptr) {
+    for (usize column = 0; column < 4; column++) {
+      for (usize row = 0; row < 4; row++) {
+        p[column][row] = _mm_set1_ps(parent->Elements[column][row]);
+      }
+    }
+  }
+
+  for (usize i = 0; i < simd_count; i += width) {
+    const comps::LocalTransform *lanes[width] = {
+        &locals[indices[i + 0]],
+        &locals[indices[i + 1]],
+        &locals[indices[i + 2]],
+        &locals[indices[i + 3]],
+    };
+
+    // aos to soa
+
+    __m128 qx = _mm_loadu_ps(lanes[0]->rotation.Elements);
+    __m128 qy = _mm_loadu_ps(lanes[1]->rotation.Elements);
+    __m128 qz = _mm_loadu_ps(lanes[2]->rotation.Elements);
+    __m128 qw = _mm_loadu_ps(lanes[3]->rotation.Elements);
+    _MM_TRANSPOSE4_PS(qx, qy, qz, qw);
+
+    // the rotation follows the translation, asserted above, so the fourth float is in bounds
+    __m128 tx = _mm_loadu_ps(lanes[0]->translation.Elements);
+    __m128 ty = _mm_loadu_ps(lanes[1]->translation.Elements);
+    __m128 tz = _mm_loadu_ps(lanes[2]->translation.Elements);
+    __m128 tw = _mm_loadu_ps(lanes[3]->translation.Elements);
+    _MM_TRANSPOSE4_PS(tx, ty, tz, tw);
+
+    // rotation, scaling by 2 / |q|^2 normalizes the quaternion
+
+    const __m128 length_sq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(qx, qx), _mm_mul_ps(qy, qy)),
+                                        _mm_add_ps(_mm_mul_ps(qz, qz), _mm_mul_ps(qw, qw)));
+    const __m128 s = _mm_div_ps(two, length_sq);
+
+    const __m128 xs = _mm_mul_ps(qx, s);
+    const __m128 ys = _mm_mul_ps(qy, s);
+    const __m128 zs = _mm_mul_ps(qz, s);
+
+    const __m128 xx = _mm_mul_ps(qx, xs);
+    const __m128 yy = _mm_mul_ps(qy, ys);
+    const __m128 zz = _mm_mul_ps(qz, zs);
+    const __m128 xy = _mm_mul_ps(qx, ys);
+    const __m128 xz = _mm_mul_ps(qx, zs);
+    const __m128 yz = _mm_mul_ps(qy, zs);
+    const __m128 wx = _mm_mul_ps(qw, xs);
+    const __m128 wy = _mm_mul_ps(qw, ys);
+    const __m128 wz = _mm_mul_ps(qw, zs);
+
+    // m[column][row]
+    __m128 m[4][4] = {
+        {_mm_sub_ps(one, _mm_add_ps(yy, zz)), _mm_add_ps(xy, wz), _mm_sub_ps(xz, wy), zero},
+        {_mm_sub_ps(xy, wz), _mm_sub_ps(one, _mm_add_ps(xx, zz)), _mm_add_ps(yz, wx), zero},
+        {_mm_add_ps(xz, wy), _mm_sub_ps(yz, wx), _mm_sub_ps(one, _mm_add_ps(xx, yy)), zero},
+        {tx, ty, tz, one},
+    };
+
+    if (parent != nullptr) {
+      __m128 result[4][4];
+
+      for (usize column = 0; column < 4; column++) {
+        for (usize row = 0; row < 4; row++) {
+          __m128 value = _mm_mul_ps(p[0][row], m[column][0]);
+          value = _mm_add_ps(value, _mm_mul_ps(p[1][row], m[column][1]));
+          value = _mm_add_ps(value, _mm_mul_ps(p[2][row], m[column][2]));
+
+          if (column == 3) {
+            value = _mm_add_ps(value, p[3][row]);
+          }
+
+          result[column][row] = value;
+        }
+      }
+
+      for (usize column = 0; column < 4; column++) {
+        for (usize row = 0; row < 4; row++) {
+          m[column][row] = result[column][row];
+        }
+      }
+    }
+
+    // soa to aos
+
+    for (usize column = 0; column < 4; column++) {
+      _MM_TRANSPOSE4_PS(m[column][0], m[column][1], m[column][2], m[column][3]);
+
+      for (usize lane = 0; lane < width; lane++) {
+        _mm_storeu_ps(worlds[indices[i + lane]].matrix.Columns[column].Elements, m[column][lane]);
+      }
+    }
+  }
+
+  compose_world_scalar(locals, worlds, indices, simd_count, count, parent);
+}
+
+#endif
+
+#ifdef TRANSFORMS_AVX
+
+__attribute__((target("avx"))) static inline __m256 load_soa_avx(const f32 *lane_0, const f32 *lane_4) {
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(lane_0)), _mm_loadu_ps(lane_4), 1);
+}
+
+// 4x4 transpose within each 128 bit half
+__attribute__((target("avx"))) static inline void transpose_avx(__m256 &a, __m256 &b, __m256 &c, __m256 &d) {
+  const __m256 t0 = _mm256_unpacklo_ps(a, b);
+  const __m256 t1 = _mm256_unpacklo_ps(c, d);
+  const __m256 t2 = _mm256_unpackhi_ps(a, b);
+  const __m256 t3 = _mm256_unpackhi_ps(c, d);
+
+  a = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+  b = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+  c = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  d = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+__attribute__((target("avx"))) static void compose_world_avx(const comps::LocalTransform *locals,
+                                                             comps::WorldMatrix *worlds, const u32 *indices,
+                                                             const usize count, const HMM_Mat4 *parent) {
+  constexpr usize width = 8;
+
+  const usize simd_count = count - count % width;
+
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 two = _mm256_set1_ps(2.0f);
+  const __m256 zero = _mm256_setzero_ps();
+
+  // broadcast parent, p[column][row]
+  __m256 p[4][4];
+
+  if (parent != nullptr) {
+    for (usize column = 0; column < 4; column++) {
+      for (usize row = 0; row < 4; row++) {
+        p[column][row] = _mm256_set1_ps(parent->Elements[column][row]);
+      }
+    }
+  }
+
+  for (usize i = 0; i < simd_count; i += width) {
+    const comps::LocalTransform *lanes[width];
+    HMM_Mat4 *matrices[width];
+
+    for (usize lane = 0; lane < width; lane++) {
+      lanes[lane] = &locals[indices[i + lane]];
+      matrices[lane] = &worlds[indices[i + lane]].matrix;
+    }
+
+    // aos to soa, lanes 0-3 in the low and 4-7 in the high half
+
+    __m256 qx = load_soa_avx(lanes[0]->rotation.Elements, lanes[4]->rotation.Elements);
+    __m256 qy = load_soa_avx(lanes[1]->rotation.Elements, lanes[5]->rotation.Elements);
+    __m256 qz = load_soa_avx(lanes[2]->rotation.Elements, lanes[6]->rotation.Elements);
+    __m256 qw = load_soa_avx(lanes[3]->rotation.Elements, lanes[7]->rotation.Elements);
+
+    __m256 tx = load_soa_avx(lanes[0]->translation.Elements, lanes[4]->translation.Elements);
+    __m256 ty = load_soa_avx(lanes[1]->translation.Elements, lanes[5]->translation.Elements);
+    __m256 tz = load_soa_avx(lanes[2]->translation.Elements, lanes[6]->translation.Elements);
+    __m256 tw = load_soa_avx(lanes[3]->translation.Elements, lanes[7]->translation.Elements);
+
+    transpose_avx(qx, qy, qz, qw);
+    transpose_avx(tx, ty, tz, tw);
+
+    // rotation, scaling by 2 / |q|^2 normalizes the quaternion
+
+    const __m256 length_sq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(qx, qx), _mm256_mul_ps(qy, qy)),
+                                           _mm256_add_ps(_mm256_mul_ps(qz, qz), _mm256_mul_ps(qw, qw)));
+    const __m256 s = _mm256_div_ps(two, length_sq);
+
+    const __m256 xs = _mm256_mul_ps(qx, s);
+    const __m256 ys = _mm256_mul_ps(qy, s);
+    const __m256 zs = _mm256_mul_ps(qz, s);
+
+    const __m256 xx = _mm256_mul_ps(qx, xs);
+    const __m256 yy = _mm256_mul_ps(qy, ys);
+    const __m256 zz = _mm256_mul_ps(qz, zs);
+    const __m256 xy = _mm256_mul_ps(qx, ys);
+    const __m256 xz = _mm256_mul_ps(qx, zs);
+    const __m256 yz = _mm256_mul_ps(qy, zs);
+    const __m256 wx = _mm256_mul_ps(qw, xs);
+    const __m256 wy = _mm256_mul_ps(qw, ys);
+    const __m256 wz = _mm256_mul_ps(qw, zs);
+
+    // m[column][row]
+    __m256 m[4][4] = {
+        {_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), _mm256_add_ps(xy, wz), _mm256_sub_ps(xz, wy), zero},
+        {_mm256_sub_ps(xy, wz), _mm256_sub_ps(one, _mm256_add_ps(xx, zz)), _mm256_add_ps(yz, wx), zero},
+        {_mm256_add_ps(xz, wy), _mm256_sub_ps(yz, wx), _mm256_sub_ps(one, _mm256_add_ps(xx, yy)), zero},
+        {tx, ty, tz, one},
+    };
+
+    if (parent != nullptr) {
+      __m256 result[4][4];
+
+      for (usize column = 0; column < 4; column++) {
+        for (usize row = 0; row < 4; row++) {
+          __m256 value = _mm256_mul_ps(p[0][row], m[column][0]);
+          value = _mm256_add_ps(value, _mm256_mul_ps(p[1][row], m[column][1]));
+          value = _mm256_add_ps(value, _mm256_mul_ps(p[2][row], m[column][2]));
+
+          if (column == 3) {
+            value = _mm256_add_ps(value, p[3][row]);
+          }
+
+          result[column][row] = value;
+        }
+      }
+
+      for (usize column = 0; column < 4; column++) {
+        for (usize row = 0; row < 4; row++) {
+          m[column][row] = result[column][row];
+        }
+      }
+    }
+
+    // soa to aos
+
+    for (usize column = 0; column < 4; column++) {
+      transpose_avx(m[column][0], m[column][1], m[column][2], m[column][3]);
+
+      for (usize lane = 0; lane < 4; lane++) {
+        _mm_storeu_ps(matrices[lane]->Columns[column].Elements, _mm256_castps256_ps128(m[column][lane]));
+        _mm_storeu_ps(matrices[lane + 4]->Columns[column].Elements, _mm256_extractf128_ps(m[column][lane], 1));
+      }
+    }
+  }
+
+  compose_world_scalar(locals, worlds, indices, simd_count, count, parent);
+}
+
+#endif
+
+void compose_world(const Backend backend, const comps::LocalTransform *locals, comps::WorldMatrix *worlds,
+                   const u32 *indices, const usize count, const HMM_Mat4 *parent) {
+  switch (backend) {
+#ifdef TRANSFORMS_AVX
+  case Backend::AVX:
+    compose_world_avx(locals, worlds, indices, count, parent);
+    return;
+#endif
+#ifdef TRANSFORMS_SSE
+  case Backend::SSE:
+    compose_world_sse(locals, worlds, indices, count, parent);
+    return;
+#endif
+  default:
+    compose_world_scalar(locals, worlds, indices, 0, count, parent);
+    return;
+  }
+}
+
+} // namespace transforms
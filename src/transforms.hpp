@@ -0,0 +1,29 @@
+#pragma once
+
+#include "components.hpp"
+
+namespace transforms {
+
+enum class Backend {
+  SCALAR,
+  SSE,
+  AVX,
+};
+
+// widest backend supported by the running cpu
+[[nodiscard]] Backend get_backend();
+
+[[nodiscard]] const c8 *get_backend_name(const Backend backend);
+
+// worlds[i] = parent * translate(translation) * rotate(rotation) of locals[i] for every i in indices, parent may be null
+void compose_world(const Backend backend, const comps::LocalTransform *locals, comps::WorldMatrix *worlds,
+                   const u32 *indices, const usize count, const HMM_Mat4 *parent);
+
+inline void compose_world(const comps::LocalTransform *locals, comps::WorldMatrix *worlds, const u32 *indices,
+                          const usize count, const HMM_Mat4 *parent) {
+  static const Backend backend = get_backend();
+
+  compose_world(backend, locals, worlds, indices, count, parent);
+}
+
+} // namespace transforms
@@ -1,40 +1,254 @@
 #include "world.hpp"
 #include "engine.hpp"
+#include "profile.hpp"
 #include "thirdparty/flecs/flecs.h"
+#include "transforms.hpp"
+#include <cmath>
+#include <cstring>
+#include <thread>
 
 namespace world {
 
+// flecs allocates through the engine allocator, its blocks are counted as ECS wherever they are made
+
+static void *os_malloc(const ecs_size_t size) {
+  return utils::aligned_alloc_16(static_cast<usize>(size), utils::MemoryTag::ECS);
+}
+
+static void *os_calloc(const ecs_size_t size) {
+  void *memory = os_malloc(size);
+  memset(memory, 0, static_cast<usize>(size));
+
+  return memory;
+}
+
+static void *os_realloc(void *memory, const ecs_size_t size) {
+  return utils::aligned_realloc_16(memory, static_cast<usize>(size), utils::MemoryTag::ECS);
+}
+
+static void os_free(void *memory) { utils::aligned_free_16(memory); }
+
+static bool set_os_api() {
+  ecs_os_set_api_defaults();
+
+  ecs_os_api_t api = ecs_os_get_api();
+  api.malloc_ = os_malloc;
+  api.calloc_ = os_calloc;
+  api.realloc_ = os_realloc;
+  api.free_ = os_free;
+
+  ecs_os_set_api(&api);
+
+  return true;
+}
+
+// statics of one file are initialized in order, so this runs before main's constructor creates the world
+[[maybe_unused]] static const bool os_api_set = set_os_api();
+
 World main;
 flecs::entity camera;
 
-void World::update() {
-  query_transform.each([](comps::Transform &transform) {
-    transform.world = HMM_QToM4(transform.rotation);
-    HMM_TranslateInplace(transform.world, transform.translation);
-  });
+// composes the moved transforms of one table slice against the table's shared parent, parent may be null
+static void compose_table(flecs::iter &it, comps::LocalTransform *locals, comps::WorldMatrix *worlds,
+                          const comps::LocalTransform *parent_local, const comps::WorldMatrix *parent_world) {
+  const bool parent_moved = parent_local != nullptr && parent_local->moved;
+  const HMM_Mat4 *parent_matrix = parent_world != nullptr ? &parent_world->matrix : nullptr;
+
+  constexpr usize batch_size = 64;
+
+  u32 batch[batch_size];
+  usize batch_count = 0;
+
+  for (const usize i : it) {
+    comps::LocalTransform &local = locals[i];
+
+    local.moved = local.dirty || parent_moved;
+
+    if (!local.moved) {
+      continue;
+    }
+
+    local.dirty = false;
+
+    batch[batch_count++] = static_cast<u32>(i);
+
+    if (batch_count == batch_size) {
+      transforms::compose_world(locals, worlds, batch, batch_count, parent_matrix);
+      batch_count = 0;
+    }
+  }
+
+  transforms::compose_world(locals, worlds, batch, batch_count, parent_matrix);
+}
+
+World::World() {
+  component<comps::LocalTransform>().add(flecs::With, component<comps::WorldMatrix>());
+
+  pipeline_fixed = pipeline().with(flecs::System).with<FixedUpdate>().build();
+
+  // systems of a phase run in creation order, so these are created first to open a profile section per phase
+  const struct {
+    const c8 *name;
+    flecs::entity_t phase;
+  } profiled_phases[] = {
+      {"PreUpdate", flecs::PreUpdate}, {"OnUpdate", flecs::OnUpdate}, {"PostUpdate", flecs::PostUpdate},
+      {"PreStore", flecs::PreStore},   {"OnStore", flecs::OnStore},
+  };
+
+  for (const auto &profiled_phase : profiled_phases) {
+    const c8 *name = profiled_phase.name;
+
+    system().kind(profiled_phase.phase).iter([name](flecs::iter &) { profile::mark(name); });
+  }
+
+  observer_mesh_set = observer<const comps::Mesh>()
+                          .event(flecs::OnSet)
+                          .each([](flecs::entity entity, const comps::Mesh &) {
+                            if (!entity.has<comps::SpatialProxy>()) {
+                              entity.add<comps::SpatialProxy>();
+                            }
+                          });
+
+  observer_proxy_remove = observer<comps::SpatialProxy>()
+                              .event(flecs::OnRemove)
+                              .each([this](comps::SpatialProxy &proxy) {
+                                if (proxy.id != spatial::null_node) {
+                                  spatial.remove(proxy.id);
+                                  proxy.id = spatial::null_node;
+                                }
+                              });
 
-  query_transform_transform.each([](comps::Transform &transform, const comps::Transform &parent_transform) {
-    transform.world = parent_transform.world * transform.world;
-  });
+  // the dirty scan only touches the local transforms, world matrices are written for moved entities alone
+
+  // roots don't depend on each other, so their tables are split across the workers
+  system_transform_roots = system<comps::LocalTransform, comps::WorldMatrix>("transform_roots")
+                               .without<comps::WorldMatrix>()
+                               .parent()
+                               .kind(flecs::PostUpdate)
+                               .multi_threaded()
+                               .iter([](flecs::iter &it, comps::LocalTransform *locals, comps::WorldMatrix *worlds) {
+                                 compose_table(it, locals, worlds, nullptr, nullptr);
+                               });
+
+  // a worker could reach a child table before another finished its slice of the parent table, so breadth first
+  // propagation stays on the main thread
+  system_transform_children =
+      system<comps::LocalTransform, comps::WorldMatrix, const comps::LocalTransform, const comps::WorldMatrix>(
+          "transform_children")
+          .term_at(3)
+          .parent()
+          .cascade()
+          .term_at(4)
+          .parent()
+          .kind(flecs::PostUpdate)
+          .iter([](flecs::iter &it, comps::LocalTransform *locals, comps::WorldMatrix *worlds,
+                   const comps::LocalTransform *parent_local, const comps::WorldMatrix *parent_world) {
+            compose_table(it, locals, worlds, parent_local, parent_world);
+          });
+
+  // the fat leaf boxes absorb small movements, so only entities that left theirs are reinserted
+  system_spatial_proxies =
+      system<const comps::LocalTransform, const comps::WorldMatrix, const comps::Mesh, comps::SpatialProxy>(
+          "spatial_proxies")
+          .kind(flecs::PostUpdate)
+          .each([this](flecs::entity entity, const comps::LocalTransform &local, const comps::WorldMatrix &world,
+                       const comps::Mesh &mesh, comps::SpatialProxy &proxy) {
+            if (proxy.id != spatial::null_node && !local.moved) {
+              return;
+            }
+
+            const spatial::AABB aabb = spatial::transform_bounds(mesh.bounds, world.matrix);
+
+            if (proxy.id == spatial::null_node) {
+              proxy.id = spatial.insert(aabb, entity.id());
+            } else {
+              spatial.move(proxy.id, aabb);
+            }
+          });
+}
+
+void World::set_worker_count(u32 count) {
+  if (count == 0) {
+    count = HMM_MAX(std::thread::hardware_concurrency(), 1u);
+  }
+
+  LOG_INFO("world: %u threads", count)
+
+  set_threads(static_cast<i32>(count));
+}
+
+void World::advance(const f64 frame_time) {
+  const f64 tick_time = 1.0 / tick_rate;
+
+  _tick_accumulator += frame_time;
+
+  u32 tick_count = 0;
+
+  profile::mark("FixedUpdate");
+
+  while (_tick_accumulator >= tick_time && tick_count < max_ticks_per_frame) {
+    run_pipeline(pipeline_fixed, static_cast<ecs_ftime_t>(tick_time));
+
+    _tick_accumulator -= tick_time;
+    tick_count++;
+  }
+
+  if (_tick_accumulator >= tick_time) {
+    _tick_accumulator = fmod(_tick_accumulator, tick_time);
+  }
+
+  _interpolation_alpha = static_cast<f32>(_tick_accumulator / tick_time);
+
+  progress(static_cast<ecs_ftime_t>(frame_time));
+}
+
+void World::finish() {
+  set_threads(0);
+
+  system_transform_roots.destruct();
+  system_transform_children.destruct();
+  system_spatial_proxies.destruct();
+
+  observer_mesh_set.destruct();
+  observer_proxy_remove.destruct();
+
+  spatial.release();
 }
 
 flecs::entity World::instantiate(const utils::NonOwner<assets::Prefab> &prefab) {
-  const flecs::entity prefab_root = entity().set(comps::Transform{});
+  const flecs::entity prefab_root = entity().set(comps::LocalTransform{});
 
-  const flecs::entity base = entity().set(prefab->meshbuffer);
+  instantiate_into(prefab_root, prefab);
+
+  return prefab_root;
+}
+
+void World::instantiate_into(flecs::entity root, const utils::NonOwner<assets::Prefab> &prefab) {
+  // below the root, so deleting the instance doesn't leave it behind
+  const flecs::entity base = entity().set(prefab->meshbuffer).child_of(root);
+
+  // parents precede their children, so one pass finds every parent already created
+  utils::DSArray<flecs::entity_t> node_entities;
+  node_entities.resize(prefab->nodes.size());
 
   for (i32 i_node = 0; i_node < prefab->nodes.size(); i_node++) {
     const assets::Prefab::Node &node = prefab->nodes[i_node];
 
-    flecs::entity prefab_entity = entity().set(node.transform).child_of(prefab_root);
+    LOG_ASSERT(node.parent < i_node);
+
+    const flecs::entity parent = node.parent >= 0 ? flecs::entity(*this, node_entities[node.parent]) : root;
+
+    flecs::entity prefab_entity = entity().set(node.transform).child_of(parent);
 
     if (node.has_mesh) {
       prefab_entity.is_a(base);
       prefab_entity.set(node.mesh);
     }
+
+    node_entities[i_node] = prefab_entity.id();
   }
 
-  return prefab_root;
+  node_entities.release();
 }
 
 } // namespace world
@@ -3,29 +3,57 @@
 #include "components.hpp"
 #include "prefab.hpp"
 #include "renderer.hpp"
+#include "spatial.hpp"
 #include "thirdparty/flecs/flecs.h"
 
 
 namespace world {
 
+// kind for systems that run at the fixed tick rate, it is no flecs phase so the frame pipeline skips them
+struct FixedUpdate {};
+
 struct World : public flecs::world {
+  flecs::entity camera;
 
-  flecs::query<comps::Transform> query_transform = query<comps::Transform>();
+  spatial::Tree spatial;
 
-  flecs::query<comps::Transform, const comps::Transform> query_transform_transform =
-      query_builder<comps::Transform, const comps::Transform>().parent().cascade().build();
+  flecs::observer observer_mesh_set;
+  flecs::observer observer_proxy_remove;
 
-  flecs::query<comps::Transform, comps::RigidBody> query_transform_rigidbody =
-      query<comps::Transform, comps::RigidBody>();
+  // PostUpdate, roots are split across the worker threads, children run serially breadth first
+  flecs::system system_transform_roots;
+  flecs::system system_transform_children;
+  flecs::system system_spatial_proxies;
 
-  flecs::query<const comps::Transform, const comps::MeshBuffer, const comps::Mesh> query_transform_meshbuffer_mesh =
-      query<const comps::Transform, const comps::MeshBuffer, const comps::Mesh>();
+  // fixed timestep, FixedUpdate systems run tick_rate times per second and at most max_ticks_per_frame times per
+  // frame, the remaining time is dropped so a slow simulation can't spiral
+  f64 tick_rate = 60.0;
+  u32 max_ticks_per_frame = 5;
 
-  flecs::entity camera;
+  flecs::entity pipeline_fixed;
+
+  World();
+
+  // number of threads multi threaded systems are split across, including the main thread, 0 uses one per hardware
+  // thread
+  void set_worker_count(u32 count);
 
-  void update();
+  // runs the due fixed ticks followed by one frame of the default pipeline
+  void advance(const f64 frame_time);
+
+  // fraction of a tick the frame is ahead of the last fixed tick
+  [[nodiscard]] f32 get_interpolation_alpha() const { return _interpolation_alpha; }
+
+  void finish();
 
   [[nodiscard]] flecs::entity instantiate(const utils::NonOwner<assets::Prefab> &prefab);
+
+  // adds the prefab's nodes below an existing root
+  void instantiate_into(flecs::entity root, const utils::NonOwner<assets::Prefab> &prefab);
+
+private:
+  f64 _tick_accumulator = 0.0;
+  f32 _interpolation_alpha = 1.0f;
 };
 
 extern World main;